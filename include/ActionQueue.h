@@ -17,62 +17,61 @@ public:
     virtual std::string getDescription() const = 0;
 };
 
-// Concrete command for stat changes
+// Concrete command for stat changes. A value type: the queue keeps it in
+// place, and it names its choice by node ID and index instead of a copy
+// of the choice text.
 class StatChangeCommand : public Command {
 public:
-    StatChangeCommand(Stats* stats, const StatEffect& effect, const std::string& desc);
+    StatChangeCommand();
+    StatChangeCommand(Stats* stats, const StatEffect& effect, int nodeId, int choiceIndex);
     void execute() override;
     void undo() override;
     std::string getDescription() const override;
 
+    int getNodeId() const;
+    int getChoiceIndex() const;
+
 private:
     Stats* targetStats;
-    StatEffect appliedEffect;
-    StatEffect reverseEffect;
-    std::string description;
+    StatEffect effect;
+    StatEffect appliedDelta;    // what execute() changed after clamping
+    int nodeId;
+    int choiceIndex;
 };
 
-// Circular buffer node for action sequences
+// One slot of the action ring
 struct ActionNode {
-    Command* command;
-    std::string actionName;
-    std::string description;
-    ActionNode* next;
-    
-    ActionNode(Command* cmd, const std::string& name, const std::string& desc);
-    ~ActionNode();
+    StatChangeCommand command;
+    const char* actionName = "";    // static label, e.g. "Choice Effect"
 };
 
-// Circular buffer implementation for undo history
+// Circular buffer of the last MAX_BUFFER_SIZE actions. Slots are fixed
+// and commands are stored by value, so tracking an action never allocates.
 class ActionQueue {
 public:
     ActionQueue();
-    ~ActionQueue();
-    
-    // Add command to circular buffer
-    void enqueue(Command* command, const std::string& actionName, const std::string& description);
-    
-    // Execute and track action
-    bool executeAndTrack(Command* command, const std::string& actionName, const std::string& description);
-    
+
+    // Execute and track action; the oldest is dropped when the buffer is full
+    void executeAndTrack(const StatChangeCommand& command, const char* actionName);
+
     // Undo last action (pops from history)
     bool undoLast(std::string& outName, std::string& outDescription);
-    
+
     // Legacy support
     bool dequeue(std::string& outName, std::string& outDescription);
     bool isEmpty() const;
     int getSize() const;
+
+    // Forget all actions; their effects stay applied
     void clear();
-    
+
     std::string peek() const;
 
 private:
-    ActionNode* head;      // Start of circular buffer
-    ActionNode* tail;      // Current position
-    int size;
     static const int MAX_BUFFER_SIZE = 10;
-    
-    void removeOldest();
+    ActionNode slots[MAX_BUFFER_SIZE];
+    int head;      // oldest action
+    int size;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,71 @@
+#ifndef DAYSCHEDULE_H
+#define DAYSCHEDULE_H
+
+#include <cstdint>
+#include <vector>
+
+// A pending game-day timer, due on an absolute day
+struct DayTimer {
+    int eventId = 0;
+    int dueDay = 0;
+    uint32_t period = 0;       // days between repeats, 0 for a one-shot
+
+    bool operator==(const DayTimer& other) const {
+        return eventId == other.eventId && dueDay == other.dueDay && period == other.period;
+    }
+
+    // Saved schedules keep their timers in this order
+    bool operator<(const DayTimer& other) const {
+        if (dueDay != other.dueDay) return dueDay < other.dueDay;
+        if (eventId != other.eventId) return eventId < other.eventId;
+        return period < other.period;
+    }
+};
+
+// An active timed modifier (ModifierPool.h), by absolute days: applied
+// on 'firstDay', gone on 'lastDay'. Stepping a day leaves it unchanged.
+struct DayModifier {
+    uint32_t target = 0;
+    int kind = 0;
+    int stacks = 1;
+    int firstDay = 0;
+    int lastDay = 0;
+
+    bool operator==(const DayModifier& other) const {
+        return target == other.target && kind == other.kind && stacks == other.stacks &&
+               firstDay == other.firstDay && lastDay == other.lastDay;
+    }
+
+    // Saved schedules keep their modifiers in this order
+    bool operator<(const DayModifier& other) const {
+        if (target != other.target) return target < other.target;
+        if (kind != other.kind) return kind < other.kind;
+        if (firstDay != other.firstDay) return firstDay < other.firstDay;
+        if (lastDay != other.lastDay) return lastDay < other.lastDay;
+        return stacks < other.stacks;
+    }
+};
+
+// The part of the event state that belongs to a game position: the
+// pending game-day timers (follow-ups such as the wound after an ice
+// crack), the active timed modifiers and the armed flag of each stat
+// rule. EventManager saves and restores it, so undo and the state
+// explorer resume a position with the same follow-ups due, the same
+// modifiers running and the same rule edges.
+struct DaySchedule {
+    std::vector<DayTimer> timers;         // sorted (DayTimer::operator<)
+    std::vector<DayModifier> modifiers;   // sorted (DayModifier::operator<)
+    std::vector<uint8_t> ruleArmed;       // one flag per rule
+
+    void clear() {
+        timers.clear();
+        modifiers.clear();
+        ruleArmed.clear();
+    }
+
+    bool operator==(const DaySchedule& other) const {
+        return timers == other.timers && modifiers == other.modifiers && ruleArmed == other.ruleArmed;
+    }
+};
+
+#endif
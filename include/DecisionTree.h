@@ -2,41 +2,98 @@
 #define DECISIONTREE_H
 
 #include "Node.h"
+#include "NodeStore.h"
 #include "Event.h"
-#include <unordered_map>
+#include "StoryImage.h"
+#include "StoryValidator.h"
+#include "GraphExporter.h"
 #include <string>
 #include <vector>
 
-// NOTE: Choice struct is defined in Node.h (included above)
-// Do NOT redefine it here!
+// NOTE: Choice and Node are views defined in Node.h (included above)
+// Do NOT redefine them here!
 
 class DecisionTree {
 private:
-    std::unordered_map<int, Node*> nodes;
+    // Flat node/choice/effect tables (see NodeStore.h), either built in
+    // code or pointing into a mapped story image
+    StoryImage image;
+    NodeStore store;
     int currentNodeId;
+    uint32_t currentIndex;
+
+    // Image whose records are checked per node on access: our own or the
+    // attached source's; null for stories built in code
+    const StoryImage* mappedImage;
+
+    static const int START_NODE_ID = 1;
+
+    // 'index' if its node can be used, else StoryFormat::NO_INDEX
+    uint32_t checkedIndex(uint32_t index) const;
 
 public:
     DecisionTree();
     ~DecisionTree();
 
     void loadNodes();
-    const Node* getCurrentNode() const;
-    
+
+    // Map a compiled story image (.wsb) instead of building nodes in code
+    bool loadFromImage(const std::string& filename);
+    bool isImageLoaded() const;
+
+    // Read-only view of another tree's story with an independent current
+    // node (one per simulation thread). The source must outlive this tree.
+    void attachStory(const DecisionTree& source);
+
+    Node getCurrentNode() const;
+    int getCurrentNodeId() const;
+
+    // Lookup by author ID or by dense index
+    Node getNode(int id) const;
+    Node getNodeAt(uint32_t index) const;
+    uint32_t getNodeCount() const;
+    const NodeStore& getStore() const;
+
     // NavigateToNode as described in Algorithm 1
     bool navigateToNode(int targetID);
-    
+
     bool makeChoice(int choiceIndex);
     void reset();
     void setCurrentNode(int nodeId);
 
+    // Builder API - call finalize() once all nodes are added
     void createNode(int id, const std::string& text, bool isEnding = false);
-    
+
     // Updated to support Choice struct with effects
     void addChoice(int nodeId, const std::string& text, int nextNodeId, const std::vector<StatEffect>& effects = {});
     void addTrigger(int nodeId, int eventId);
     void setNodeEndingType(int nodeId, const std::string& type);
+    void removeNode(int nodeId);
+
+    // Resume building on top of the loaded story (built or mapped), e.g. to
+    // patch individual nodes; createNode then redefines instead of replacing
+    void editStory();
+
+    // Packs the tables and validates the graph, reporting errors on std::cerr
+    void finalize();
+
+    // Dangling targets, unreachable nodes, dead ends and cycles
+    StoryDiagnostics validate() const;
 
     void generateDotFile(const std::string& filename) const;
+
+    // Streaming export of the whole graph, or of the nodes within
+    // 'hops' choices of the current node (for quick previews); the
+    // number of nodes written goes to 'nodeCount' if given
+    bool exportGraph(const std::string& filename, GraphFormat format) const;
+    bool exportNeighborhood(const std::string& filename, GraphFormat format, int hops,
+                            size_t* nodeCount = nullptr) const;
+
+    // Write the current nodes as a compiled story image
+    bool compileImage(const std::string& filename) const;
+
+    DecisionTree(const DecisionTree&) = delete;
+    DecisionTree& operator=(const DecisionTree&) = delete;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -1,8 +1,10 @@
 #ifndef EVENT_H
 #define EVENT_H
 
+#include "InlineFunction.h"
+#include <cstdint>
 #include <string>
-#include <functional>
+#include <string_view>
 
 // Priority levels for event queue
 enum class Priority {
@@ -12,24 +14,82 @@ enum class Priority {
     CRITICAL = 4
 };
 
-// Stat changes that can be applied
+// Stat columns, in StatEffect lane order
+enum class StatId : unsigned char {
+    Health,
+    Hunger,
+    Stamina,
+    PackStatus,
+    Morale,
+    Strength,
+    XP
+};
+const int STAT_COUNT = 7;
+
+// Stat changes that can be applied, as a packed vector: one int32 lane
+// per StatId plus a spare lane that is always 0, so a whole effect is
+// 32 bytes and adds with a couple of vector instructions. Effects
+// compose by addition; the sum of a choice's effects is precomputed
+// (Choice::getEffect).
 struct StatEffect {
-    int healthChange;
-    int hungerChange;
-    int staminaChange;
-    int packStatusChange;
-    int moraleChange;
-    int strengthChange;
-    int xpGain;
-    
-    StatEffect(int h = 0, int hu = 0, int st = 0, int p = 0, 
-               int m = 0, int str = 0, int xp = 0);
-    
+    static constexpr int LANES = 8;
+
+    int32_t lanes[LANES];
+
+    constexpr StatEffect(int h = 0, int hu = 0, int st = 0, int p = 0,
+                         int m = 0, int str = 0, int xp = 0)
+        : lanes{h, hu, st, p, m, str, xp, 0} {}
+
+    constexpr int32_t operator[](StatId stat) const { return lanes[static_cast<int>(stat)]; }
+    constexpr int32_t& operator[](StatId stat) { return lanes[static_cast<int>(stat)]; }
+
+    constexpr StatEffect& operator+=(const StatEffect& other) {
+        for (int i = 0; i < LANES; ++i) lanes[i] += other.lanes[i];
+        return *this;
+    }
+
+    constexpr StatEffect& operator*=(int factor) {
+        for (int i = 0; i < LANES; ++i) lanes[i] *= factor;
+        return *this;
+    }
+
+    constexpr StatEffect operator-() const {
+        StatEffect result;
+        for (int i = 0; i < LANES; ++i) result.lanes[i] = -lanes[i];
+        return result;
+    }
+
+    constexpr bool isZero() const {
+        for (int i = 0; i < LANES; ++i) {
+            if (lanes[i] != 0) return false;
+        }
+        return true;
+    }
+
     // Return inverse effect for undo
-    StatEffect reverse() const;
+    constexpr StatEffect reverse() const { return -*this; }
 };
 
-// Event class with priority and effects
+constexpr StatEffect operator+(StatEffect a, const StatEffect& b) { return a += b; }
+constexpr StatEffect operator-(StatEffect a, const StatEffect& b) { return a += -b; }
+constexpr StatEffect operator*(StatEffect a, int factor) { return a *= factor; }
+
+constexpr bool operator==(const StatEffect& a, const StatEffect& b) {
+    for (int i = 0; i < StatEffect::LANES; ++i) {
+        if (a.lanes[i] != b.lanes[i]) return false;
+    }
+    return true;
+}
+
+constexpr bool operator!=(const StatEffect& a, const StatEffect& b) { return !(a == b); }
+
+static_assert(sizeof(StatEffect) == 32, "StatEffect is one 8-lane vector");
+static_assert((StatEffect(1, 2) + StatEffect(0, -2, 3)) * 2 == StatEffect(2, 0, 6), "StatEffect arithmetic");
+
+// Custom event action; captures must fit in 48 bytes (no heap fallback)
+using EventAction = InlineFunction<void(), 48>;
+
+// Event class with priority and effects. Move-only, since actions are.
 class Event {
 public:
     Event(int id = 0,
@@ -38,13 +98,16 @@ public:
           const StatEffect& effect = StatEffect());
     
     int getId() const;
-    std::string getDescription() const;
+    std::string_view getDescription() const;
     Priority getPriority() const;
     const StatEffect& getEffect() const;
     
     // Execute custom action
     virtual void execute();
-    void setAction(std::function<void()> act);
+    void setAction(EventAction act);
+
+    // Reuse this object for a new event, keeping the description's buffer
+    void reset(int newId, std::string_view newDescription, Priority newPriority, const StatEffect& newEffect);
     
     // Comparison for priority queue
     bool operator<(const Event& other) const;
@@ -54,7 +117,7 @@ private:
     std::string description;
     Priority priority;
     StatEffect effect;
-    std::function<void()> action;
+    EventAction action;
 };
 
 #endif
\ No newline at end of file
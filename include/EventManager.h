@@ -1,46 +1,274 @@
 #ifndef EVENTMANAGER_H
 #define EVENTMANAGER_H
 
+#include "DaySchedule.h"
 #include "Event.h"
+#include "EventQueue.h"
+#include "ModifierPool.h"
+#include "MpscQueue.h"
+#include "PendingTable.h"
+#include "StatRules.h"
 #include "Stats.h"
-#include <map>
-#include <queue>
+#include "TimerWheel.h"
+#include <atomic>
+#include <cstdint>
 #include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// What the event queue carries instead of Event copies. Registered
+// events are resolved in place from the registry; events built by
+// pushEvent live in an instance arena until they are released.
+struct EventHandle {
+    static constexpr uint32_t NONE = 0xFFFFFFFFu;
+
+    uint32_t slot = NONE;       // registry slot, NONE for pushed events
+    uint32_t instance = NONE;   // instance arena index, NONE for registered events
+
+    bool isRegistered() const { return slot != NONE; }
+};
+
+// Per-tick dispatch limits; 0 means no limit
+struct DispatchBudget {
+    size_t maxEvents = 0;
+    int maxMicroseconds = 0;
+};
+
+// What one update() call did
+struct DispatchStats {
+    size_t queuedBefore = 0;   // queue depth at the start of the tick
+    size_t drained = 0;        // events dispatched
+    size_t dropped = 0;        // events below the minimum priority
+    size_t remaining = 0;      // left for the next tick by the budget or window
+    size_t coalesced = 0;      // duplicate triggers merged since the last tick
+};
+
+// Event posted from another thread; text is truncated to fit
+struct PostedEvent {
+    static const size_t TEXT_SIZE = 56;
+
+    int eventId = -1;                      // registered event, -1 for a text event
+    Priority priority = Priority::MEDIUM;
+    char text[TEXT_SIZE] = {};
+};
+
+// Cross-thread ingestion counters
+struct IngressStats {
+    uint64_t posted = 0;    // accepted by postEvent
+    uint64_t dropped = 0;   // rejected because the queue was full
+    uint64_t drained = 0;   // moved into the priority queue by update()
+};
+
+// Clock a timer counts in
+enum class TimerDomain {
+    GameDays,    // advanced by setDay()
+    RealTime     // milliseconds, advanced by advanceRealTime()
+};
 
 class EventManager {
 public:
+    // 'followUpId' is scheduled 'delayDays' after 'eventId' triggers
+    struct FollowUp {
+        int eventId;
+        int followUpId;
+        uint32_t delayDays;
+        uint32_t periodDays;
+    };
+
+    // Called for each dispatched event of one priority class, after its
+    // action and effect have been applied; repeatCount > 1 for merged duplicates
+    using EventHandler = std::function<void(const Event&, int repeatCount)>;
+
+    static constexpr int MAX_EVENT_ID = (1 << 22) - 1;
+
+    static const size_t INGRESS_CAPACITY = 4096;
+
     EventManager();
 
-    // Register an event template
+    // Register an event template. IDs index a dense remap table, so they
+    // should be small and mostly contiguous (0..MAX_EVENT_ID). Fails for
+    // duplicate or out-of-range IDs and once the registry is frozen.
     bool registerEvent(int id,
                        const std::string& description,
                        Priority priority,
                        const StatEffect& effect);
 
+    // Size the registry ahead of a bulk load (see StoryParser::loadEvents)
+    void reserve(size_t count, int maxId);
+
+    // Make the registry and rule table read-only; registration after this fails
+    void freeze();
+    bool isFrozen() const;
+
+    size_t getRegisteredCount() const;
+    const Event* findEvent(int id) const;
+
     // Trigger a registered event (adds to queue)
     bool triggerEvent(int eventId);
+
+    // Trigger a registered event for immediate handling by the caller,
+    // bypassing the queue; nullptr if it is not registered
+    const Event* dispatchNow(int eventId);
     
+    // Thread-safe posting for background systems. Never blocks: when
+    // the bounded ingestion queue is full the event is dropped, counted
+    // and false is returned. Posted events enter the priority queue at
+    // the start of the next update().
+    bool postEvent(int eventId);
+    bool postEvent(Priority p, std::string_view msg);
+    IngressStats getIngressStats() const;
+
     // Push event directly to queue (as described in Listing 5.1)
-    void pushEvent(Priority p, const std::string& msg, std::function<void()> action);
+    void pushEvent(Priority p, std::string_view msg, EventAction action = nullptr);
 
     bool hasEvents() const;
+    size_t getQueuedCount() const;
 
-    // Get and execute highest-priority event (implements Algorithm 2)
-    Event getNextEvent();
+    // Take the highest-priority event; FIFO among equal priorities.
+    // Only valid when hasEvents(). The handle stays resolvable until
+    // release() is called for it. 'repeatCount' receives the number of
+    // triggers merged into it.
+    EventHandle popEvent(int* repeatCount = nullptr);
+    Event& resolve(EventHandle handle);
+    void release(EventHandle handle);
     
-    // Update method - processes events with threshold and notification (Algorithm 2)
-    void update(Stats* stats, std::function<void(const std::string&)> notifyUI);
+    // Drain pending events in priority order until the queue is empty or
+    // the budget runs out. Each event runs its action and effect, then
+    // its class handler, or notifyUI when the class has none.
+    DispatchStats update(Stats* stats, const std::function<void(std::string_view)>& notifyUI);
+
+    void setBudget(const DispatchBudget& budget);
+    void setHandler(Priority priority, EventHandler handler);
+
+    // Events below this priority are discarded and counted as dropped
+    void setMinimumPriority(Priority priority);
+
+    // Merge a trigger of a registered event, or a pushEvent with the same
+    // priority and message, into the occurrence already queued: its
+    // effect is multiplied by the repeat count and its action runs once.
+    // With windowTicks > 0 an occurrence is held back for that many
+    // update() calls so later duplicates can still join it. On by default
+    // with no window (duplicates within one tick).
+    void setCoalescing(bool enabled, uint32_t windowTicks = 0);
+
+    const DispatchStats& getLastTick() const;
     
-    // Stat polling for automatic event triggering (Ch 5.2)
+    // Threshold rule that triggers a registered event; fails once frozen
+    bool addRule(const StatRule& rule);
+    const StatRuleSet& getRules() const;
+
+    // Stat polling for automatic event triggering (Ch 5.2). Rules are
+    // edge-triggered: each fires once per threshold crossing.
     void pollStats(Stats* stats);
 
+    // Derive rule state from 'stats' alone. Inside a rule's hysteresis
+    // band this cannot tell a rule that fired from one that did not, so
+    // saved positions keep the flags with saveSchedule() instead.
+    void syncRules(const Stats* stats);
+
+    // Trigger a registered event after 'delay' days or milliseconds, and
+    // then every 'period' if it is non-zero. Expired timers are queued
+    // in one batch when their clock advances.
+    TimerId scheduleEvent(int eventId, TimerDomain domain, uint32_t delay, uint32_t period = 0);
+    bool cancelTimer(TimerDomain domain, TimerId id);
+    size_t getPendingTimers() const;
+
+    // Schedule 'followUpId' whenever 'eventId' is triggered, e.g. a
+    // wound that worsens a few days later; fails once frozen
+    bool addFollowUp(int eventId, int followUpId, uint32_t delayDays, uint32_t periodDays = 0);
+    const std::vector<FollowUp>& getFollowUps() const;
+
+    // Timed modifier kinds (wounded, well fed, exhausted, ...), numbered
+    // from 0; -1 for a duplicate name or a zero duration, or once frozen
+    int defineModifier(const std::string& name, const ModifierType& type);
+    int findModifier(std::string_view name) const;
+    std::string_view getModifierName(int kind) const;
+
+    // Add a 'kind' modifier to the player whenever 'eventId' is
+    // triggered, the same way follow-ups are scheduled; fails once frozen
+    bool addModifier(int eventId, int kind);
+
+    // The player's (target 0) active timed modifiers; the owner of the
+    // Stats steps them once per game day
+    ModifierPool& getModifiers();
+    const ModifierPool& getModifiers() const;
+
+    // The pending game-day timers, modifiers and rule flags of the
+    // current position. restoreSchedule() replaces all three and moves
+    // the day clock to 'day' (either way); the TimerIds of replaced
+    // timers become stale.
+    void saveSchedule(DaySchedule& out) const;
+    void restoreSchedule(int day, const DaySchedule& schedule);
+
+    // Advance the clocks; only forward movement has an effect (see
+    // restoreSchedule() for going back)
+    void setDay(int day);
+    void advanceRealTime(double seconds);
+
+    // Empty the queue, cancel all timers, drop all modifiers and re-arm
+    // all rules
     void clear();
 
 private:
-    std::map<int, Event> eventRegistry;
-    std::priority_queue<Event> eventQueue;
-    
-    static const int CRITICAL_THRESHOLD = 20; // For Algorithm 2
+    std::vector<uint32_t> slotById;           // event ID -> slot, NONE if unregistered
+    std::vector<Event> registeredEvents;       // indexed by slot
+    bool frozen;
+    std::vector<Event> instances;              // events from pushEvent
+    std::vector<uint32_t> freeInstances;
+    EventQueue<EventHandle> eventQueue;
+
+    // Coalescing state: key is registry slot + 1, or a message hash with
+    // the top bit set for pushed events. Events queued while coalescing
+    // is off have key 0 and are never looked up.
+    PendingTable pending;
+    std::vector<uint64_t> instanceKeys;        // by instance index; 0 if queued untracked
+    std::vector<EventHandle> deferred;         // held back by the window
+    bool coalescing;
+    uint32_t coalesceWindow;
+    uint32_t tickCount;
+    size_t coalescedSinceTick;
+
+    DispatchBudget budget;
+    EventHandler handlers[EventQueue<EventHandle>::LEVELS];
+    Priority minimumPriority;
+    DispatchStats lastTick;
+
+    StatRuleSet statRules;
+    std::vector<uint8_t> ruleArmed;   // one flag per rule for the polled Stats
+    std::vector<uint8_t> ruleFired;
+
+    std::vector<FollowUp> followUps;
+    std::vector<uint8_t> hasFollowUp;     // by registry slot
+
+    struct ModifierLink {
+        int eventId;
+        int kind;
+    };
+    ModifierPool modifiers;
+    std::vector<std::string> modifierNames;   // by kind
+    std::vector<ModifierLink> modifierLinks;
+    std::vector<uint8_t> hasModifier;     // by registry slot
+
+    TimerWheel dayTimers;
+    TimerWheel realTimers;
+    double realTimeCarry;                 // milliseconds not yet on the wheel
+    std::vector<int> expiredEvents;       // reused by every advance
+    mutable std::vector<TimerWheel::Pending> pendingTimers;   // reused by saveSchedule
+
+    MpscQueue<PostedEvent> ingress;
+    std::atomic<uint64_t> ingressPosted;
+    std::atomic<uint64_t> ingressDropped;
+    uint64_t ingressDrained;
+
+    void prepareRules();
+    void drainIngress();
+    bool mergePending(uint64_t key);
+    uint64_t keyOf(EventHandle handle) const;
+    void queueExpired();
+    void scheduleFollowUps(int eventId);
+    void applyModifiers(int eventId);
+    static void columnsOf(const Stats* stats, int* values, StatColumns& columns);
 };
 
 #endif
\ No newline at end of file
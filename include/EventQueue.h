@@ -0,0 +1,115 @@
+#ifndef EVENTQUEUE_H
+#define EVENTQUEUE_H
+
+#include "Event.h"
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// ============================================================
+// Priority queue specialised for the four Priority levels: one ring
+// buffer per level plus a bitmask of the non-empty levels. push and
+// pop are O(1), and items of the same priority come out in the order
+// they were pushed, so event order is deterministic for replays.
+// ============================================================
+template <typename T>
+class EventQueue {
+public:
+    static const int LEVELS = 4;
+
+    EventQueue() : mask(0) {}
+
+    void push(Priority priority, const T& item) { ringFor(priority).push(item); }
+    void push(Priority priority, T&& item) { ringFor(priority).push(std::move(item)); }
+
+    bool empty() const { return mask == 0; }
+
+    size_t size() const {
+        size_t total = 0;
+        for (const Ring& ring : rings) total += ring.count;
+        return total;
+    }
+
+    size_t size(Priority priority) const { return rings[levelOf(priority)].count; }
+
+    // Highest non-empty priority; only valid when !empty()
+    Priority topPriority() const { return static_cast<Priority>(highestLevel() + 1); }
+
+    T& front() { return rings[highestLevel()].front(); }
+
+    // Remove and return the oldest item of the highest priority
+    T pop() {
+        int level = highestLevel();
+        Ring& ring = rings[level];
+        T item = ring.pop();
+        if (ring.count == 0) mask &= ~(1u << level);
+        return item;
+    }
+
+    // Drops queued items but keeps the buffers for reuse
+    void clear() {
+        for (Ring& ring : rings) ring.clear();
+        mask = 0;
+    }
+
+private:
+    struct Ring {
+        std::vector<T> slots;   // capacity is a power of two
+        size_t head = 0;
+        size_t count = 0;
+
+        template <typename U>
+        void push(U&& item) {
+            if (count == slots.size()) grow();
+            slots[(head + count) & (slots.size() - 1)] = std::forward<U>(item);
+            ++count;
+        }
+
+        T& front() { return slots[head]; }
+
+        T pop() {
+            T item = std::move(slots[head]);
+            head = (head + 1) & (slots.size() - 1);
+            --count;
+            return item;
+        }
+
+        void clear() {
+            for (size_t i = 0; i < count; ++i) slots[(head + i) & (slots.size() - 1)] = T();
+            head = 0;
+            count = 0;
+        }
+
+        void grow() {
+            std::vector<T> larger(slots.empty() ? 16 : slots.size() * 2);
+            for (size_t i = 0; i < count; ++i) {
+                larger[i] = std::move(slots[(head + i) & (slots.size() - 1)]);
+            }
+            slots.swap(larger);
+            head = 0;
+        }
+    };
+
+    Ring rings[LEVELS];
+    uint32_t mask;   // bit n set while level n is non-empty
+
+    static int levelOf(Priority priority) {
+        int level = static_cast<int>(priority) - 1;
+        return level < 0 ? 0 : (level >= LEVELS ? LEVELS - 1 : level);
+    }
+
+    Ring& ringFor(Priority priority) {
+        int level = levelOf(priority);
+        mask |= 1u << level;
+        return rings[level];
+    }
+
+    int highestLevel() const {
+        // Index of the highest set bit for every 4-bit mask
+        static const int8_t HIGHEST[16] = { -1, 0, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3 };
+        return HIGHEST[mask];
+    }
+};
+
+#endif
@@ -0,0 +1,85 @@
+#ifndef EVENTTRACE_H
+#define EVENTTRACE_H
+
+#include "Event.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ============================================================
+// Binary event trace (.wtr)
+// Every queued, dispatched, dropped and immediately handled event is
+// written as one fixed-size Record. Records collect in a buffer per
+// thread and reach the file in blocks, so recording is a clock read and
+// a 40-byte store. Timestamps are CPU ticks where available; the header
+// holds the tick rate measured between open() and close().
+//
+//   Header | Record[]   (records of one thread are in time order)
+//
+// Tracing is compiled in unless WOLF_NO_TRACE is defined, and records
+// nothing until a trace file is opened. wolf_trace reads the files.
+// ============================================================
+
+namespace EventTrace {
+
+const uint32_t MAGIC = 0x31525457;        // "WTR1" little-endian
+const uint32_t VERSION = 1;
+
+enum class RecordKind : uint8_t {
+    Queued = 1,        // triggerEvent/pushEvent, including merged duplicates
+    Dispatched = 2,    // applied by update(); repeat = merged triggers
+    Dropped = 3,       // discarded below the minimum priority
+    Immediate = 4      // dispatchNow(), handled by the caller
+};
+
+struct Header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t recordSize;
+    uint32_t reserved;
+    double ticksPerSecond;    // 0 if the trace was never closed
+};
+
+struct Record {
+    uint64_t timestamp;       // ticks
+    int32_t eventId;          // -1 for pushed events
+    int32_t node;             // story node when recorded (setContext)
+    int32_t day;
+    uint8_t kind;             // RecordKind
+    uint8_t priority;         // Priority
+    uint16_t repeat;
+    int16_t delta[7];         // effect in StatEffect order, times repeat
+    uint16_t thread;          // recording thread, numbered from 0
+};
+
+static_assert(sizeof(Record) == 40, "trace records are fixed-size");
+
+// Start recording to 'path', replacing the file. Fails if a trace is
+// already open.
+bool open(const std::string& path, std::string& error);
+
+// Flush this thread's records, write the tick rate and close the file.
+// Other threads' records are written when their buffer fills or the
+// thread exits, so finish worker threads before closing.
+void close();
+
+bool isOpen();
+
+// Day and story node stamped on this thread's following records
+void setContext(int day, int node);
+
+void record(RecordKind kind, int eventId, Priority priority, int repeat, const StatEffect& effect);
+
+// Read a whole trace file
+bool load(const std::string& path, Header& header, std::vector<Record>& records, std::string& error);
+
+}
+
+// Compiled out, the arguments are still type-checked but never evaluated
+#ifdef WOLF_NO_TRACE
+#define WOLF_TRACE(...) do { if (false) EventTrace::record(__VA_ARGS__); } while (0)
+#else
+#define WOLF_TRACE(...) EventTrace::record(__VA_ARGS__)
+#endif
+
+#endif
@@ -0,0 +1,118 @@
+#ifndef GAMESESSION_H
+#define GAMESESSION_H
+
+#include "DecisionTree.h"
+#include "EventManager.h"
+#include "GameState.h"
+#include "StatHistory.h"
+#include "ActionQueue.h"
+#include "Event.h"
+#include <functional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Feedback reported by a session; the frontend decides how to present it
+enum class SessionMessage {
+    ChoiceMade,
+    ItemFound,
+    Hazard,
+    EventApplied,
+    StateRestored,
+    NothingToUndo,
+    HistoryCleared
+};
+
+struct SessionOptions {
+    bool trackHistory = true;    // GameStateStack undo journal and ActionQueue commands
+    bool keepEventLog = true;    // applied events kept for display
+    bool keepStatHistory = true; // StatHistory samples per day and per tick
+    bool verbose = true;         // progress lines on std::cout
+    unsigned int seed = 0;       // 0 = seed from std::random_device
+    std::string eventsPath;      // event data file; empty = built-in events
+};
+
+// ============================================================
+// Headless game engine: the choice-resolution pipeline from the
+// original gameLoop, with no dependency on GLFW or ImGui.
+// ============================================================
+class GameSession {
+public:
+    using Listener = std::function<void(SessionMessage, std::string_view)>;
+
+    explicit GameSession(DecisionTree& tree, const SessionOptions& options = SessionOptions());
+    ~GameSession();
+
+    // Reset stats, inventory, history and story position
+    void restart();
+    void setListener(Listener listener);
+
+    // Resolve a choice at the current node: push history, apply choice
+    // effects, advance the day and its modifiers, trigger node events,
+    // roll a random encounter and poll stats. Returns false for an
+    // invalid choice.
+    bool choose(int choiceIndex);
+
+    // Same as choose() with an explicit encounter roll (1..100)
+    bool resolveChoice(int choiceIndex, int roll);
+
+    // One roll from each distinct outcome of the random encounter table
+    static const std::vector<int>& getEncounterRolls();
+
+    // Dispatch queued events within the event manager's budget
+    void tick();
+
+    // Tick until the event queue is empty
+    void drainEvents();
+
+    // choose() followed by drainEvents()
+    bool step(int choiceIndex);
+
+    // Step back one choice: the saved state, the pending day timers and
+    // the rule flags of that moment
+    bool undo();
+    void clearHistory();
+
+    bool isOver() const;
+    std::string_view getEndingText() const;
+
+    GameState& getState();
+    const GameState& getState() const;
+    DecisionTree& getTree();
+    EventManager& getEvents();
+    GameStateStack& getHistory();
+    ActionQueue& getActions();
+
+    // Timed modifiers on the player (target 0): events add them (see
+    // EventManager::addModifier) and each day steps them. They are saved
+    // with the day schedule, so undo restores them too.
+    ModifierPool& getModifiers();
+
+    // Stats sampled after each day is resolved and after each tick
+    const StatHistory& getStatHistory() const;
+    std::vector<Event>& getEventLog();
+
+private:
+    DecisionTree& tree;
+    SessionOptions options;
+    EventManager events;
+    GameState state;
+    GameStateStack history;
+    DaySchedule schedule;        // reused for every push and undo
+    ActionQueue actions;
+    StatHistory statHistory;
+    std::vector<Event> eventLog;
+    std::mt19937 rng;
+    std::uniform_int_distribution<int> encounterRoll;
+    Listener listener;
+
+    void registerEvents();
+    void generateRandomEvent(int roll);
+    void notify(SessionMessage message, std::string_view text);
+
+    GameSession(const GameSession&) = delete;
+    GameSession& operator=(const GameSession&) = delete;
+};
+
+#endif
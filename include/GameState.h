@@ -1,8 +1,13 @@
 #ifndef GAMESTATE_H
 #define GAMESTATE_H
 
+#include "DaySchedule.h"
 #include "Stats.h"
 #include "Inventory.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
 
 // Centralized GameState struct as described in Ch 6.3
 struct GameState {
@@ -15,41 +20,82 @@ struct GameState {
     GameState() : currentNodeId(1), day(1), packSize(1), inventory(nullptr) {}
 };
 
-// Stack node for game state history (undo functionality)
-struct GameStateNode {
-    int currentNodeId;
-    Stats stats;
-    Inventory* inventory;
-    int day;
-    int packSize;
-    GameStateNode* next;
-    
-    GameStateNode(int nodeId, const Stats& s, Inventory* inv, int d, int pack);
-    ~GameStateNode();
-};
-
-// Stack for undo history as described in Ch 6
+// ============================================================
+// Undo history (Ch 6) kept as a delta journal.
+// The most recent saved state is held whole; each older one is stored
+// as its difference to the state saved after it: a field mask, then a
+// zigzag varint per changed field, then the step's length (a varint
+// stored back to front) so the journal can be walked backwards.
+//
+//   mask | node | stats... | pack | day | inventory | timers | rules | modifiers | length
+//
+// Differences are taken between saved values rather than the effects
+// that produced them, so undo is exact even where a stat was clamped.
+// The inventory is written only on steps where it changed, as indices
+// into a table of item kinds. The event schedule (pending day timers,
+// rule flags and timed modifiers, see DaySchedule.h) is journaled as
+// changes: the timers and modifiers a step added and removed and the
+// rule flags it flipped. On the
+// built-in story a choice costs about 5 bytes (see wolf_check).
+// ============================================================
 class GameStateStack {
 public:
     GameStateStack();
-    ~GameStateStack();
     
-    void push(int nodeId, const Stats& stats, Inventory* inventory, int day, int packSize);
-    bool pop(int& outNodeId, Stats& outStats, Inventory*& outInventory, int& outDay, int& outPackSize);
+    // 'schedule' timers and modifiers must be in DaySchedule order, as
+    // saveSchedule() leaves them
+    void push(int nodeId, const Stats& stats, Inventory* inventory, int day, int packSize,
+              const DaySchedule* schedule = nullptr);
     
-    // Undo implementation (Algorithm 3)
-    bool undo(GameState& outState);
+    // Undo implementation (Algorithm 3): restore the last pushed state.
+    // outState.inventory and 'schedule', if set, are overwritten in place.
+    bool undo(GameState& outState, DaySchedule* schedule = nullptr);
     
     int getSize() const;
     bool isEmpty() const;
     void clear();
 
+    // Journal, item table and the whole latest state
+    size_t getMemoryUsage() const;
+
+    // Encoded steps only, i.e. what each push past the first adds
+    size_t getJournalSize() const;
+
+    // Past this, the oldest eighth of the steps is dropped in one go
+    static const int MAX_SIZE = 50000;
+
 private:
-    GameStateNode* top;
+    struct ItemKind {
+        std::string name;
+        std::string type;
+        int effect;
+    };
+
+    struct Snapshot {
+        int nodeId = 0;
+        Stats stats;
+        Inventory inventory;
+        int day = 0;
+        int packSize = 0;
+        DaySchedule schedule;
+    };
+
+    std::vector<uint8_t> journal;
+    std::vector<ItemKind> kinds;
+    Snapshot latest;
     int size;
-    static const int MAX_SIZE = 5;
-    
-    Inventory* copyInventory(Inventory* original);
+    std::vector<uint32_t> removedEntries;   // scratch for the schedule writers
+    std::vector<uint32_t> addedEntries;
+
+    void writeStep(const Snapshot& older, const Snapshot& newer);
+    size_t readStep(size_t begin, Snapshot* state) const;
+    void writeInventory(const Inventory& inventory);
+    void writeTimers(const std::vector<DayTimer>& older, const std::vector<DayTimer>& newer, int day);
+    void writeModifiers(const std::vector<DayModifier>& older, const std::vector<DayModifier>& newer, int day);
+    void writeRules(const std::vector<uint8_t>& older, const std::vector<uint8_t>& newer);
+    void writeIndices(const std::vector<uint32_t>& indices);
+    uint32_t kindOf(const InventoryNode& item);
+    void dropOldest();
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,49 @@
+#ifndef GRAPHEXPORTER_H
+#define GRAPHEXPORTER_H
+
+#include "NodeStore.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum class GraphFormat {
+    Dot,        // Graphviz
+    GraphML,    // XML, with node text and ending types as attributes
+    BinaryCsr   // compact adjacency, layout below
+};
+
+// Binary CSR adjacency file (.wcsr), little-endian:
+//
+//   CsrHeader | int32 nodeIds[nodeCount] | uint8 endingFlags[nodeCount] |
+//   (padding to 4) | uint32 offsets[nodeCount + 1] | uint32 targets[edgeCount]
+//
+// Edges of node i are targets[offsets[i] .. offsets[i + 1]), in choice
+// order, as indices into nodeIds.
+struct CsrHeader {
+    uint32_t magic;         // "WCSR"
+    uint32_t version;
+    uint32_t nodeCount;
+    uint32_t edgeCount;
+};
+
+// ============================================================
+// Streaming graph export. Output goes through one fixed write buffer
+// and node/choice data is read straight from the NodeStore tables, so
+// memory use does not grow with story size.
+// ============================================================
+namespace GraphExporter {
+    const uint32_t CSR_MAGIC = 0x52534357;   // "WCSR" little-endian
+    const uint32_t CSR_VERSION = 1;
+
+    // Export every node
+    bool write(const NodeStore& store, const std::string& filename, GraphFormat format);
+
+    // Export only the given nodes (dense indices, sorted) and the edges between them
+    bool writeSubgraph(const NodeStore& store, const std::vector<uint32_t>& nodes,
+                       const std::string& filename, GraphFormat format);
+
+    // Nodes within 'hops' choices of 'center', sorted
+    std::vector<uint32_t> neighborhood(const NodeStore& store, uint32_t center, int hops);
+}
+
+#endif
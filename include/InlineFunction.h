@@ -0,0 +1,113 @@
+#ifndef INLINEFUNCTION_H
+#define INLINEFUNCTION_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+template <typename Signature, size_t Capacity>
+class InlineFunction;
+
+// ============================================================
+// Move-only callable stored inside the object itself. Unlike
+// std::function there is no heap fallback: a callable larger than
+// Capacity (or over-aligned) is a compile error, so constructing,
+// moving and calling one never allocates.
+// ============================================================
+template <typename R, typename... Args, size_t Capacity>
+class InlineFunction<R(Args...), Capacity> {
+public:
+    InlineFunction() : ops(nullptr) {}
+    InlineFunction(std::nullptr_t) : ops(nullptr) {}
+
+    template <typename F,
+              typename = typename std::enable_if<
+                  !std::is_same<typename std::decay<F>::type, InlineFunction>::value>::type>
+    InlineFunction(F&& f) : ops(nullptr) {
+        using Fn = typename std::decay<F>::type;
+        static_assert(sizeof(Fn) <= Capacity, "callable does not fit in InlineFunction");
+        static_assert(alignof(Fn) <= alignof(std::max_align_t), "callable is over-aligned");
+        static_assert(std::is_nothrow_move_constructible<Fn>::value, "callable must be nothrow movable");
+        new (storage) Fn(std::forward<F>(f));
+        ops = &Model<Fn>::table;
+    }
+
+    InlineFunction(InlineFunction&& other) noexcept : ops(nullptr) {
+        moveFrom(other);
+    }
+
+    InlineFunction& operator=(InlineFunction&& other) noexcept {
+        if (this != &other) {
+            reset();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    InlineFunction& operator=(std::nullptr_t) {
+        reset();
+        return *this;
+    }
+
+    ~InlineFunction() { reset(); }
+
+    InlineFunction(const InlineFunction&) = delete;
+    InlineFunction& operator=(const InlineFunction&) = delete;
+
+    explicit operator bool() const { return ops != nullptr; }
+
+    R operator()(Args... args) {
+        return ops->invoke(storage, std::forward<Args>(args)...);
+    }
+
+    void reset() {
+        if (ops) {
+            ops->destroy(storage);
+            ops = nullptr;
+        }
+    }
+
+private:
+    struct Ops {
+        R (*invoke)(void*, Args&&...);
+        void (*move)(void* to, void* from);
+        void (*destroy)(void*);
+    };
+
+    template <typename Fn>
+    struct Model {
+        static R invoke(void* p, Args&&... args) {
+            return (*static_cast<Fn*>(p))(std::forward<Args>(args)...);
+        }
+        static void move(void* to, void* from) {
+            new (to) Fn(std::move(*static_cast<Fn*>(from)));
+            static_cast<Fn*>(from)->~Fn();
+        }
+        static void destroy(void* p) {
+            static_cast<Fn*>(p)->~Fn();
+        }
+        static const Ops table;
+    };
+
+    alignas(std::max_align_t) unsigned char storage[Capacity];
+    const Ops* ops;
+
+    void moveFrom(InlineFunction& other) {
+        if (!other.ops) return;
+        other.ops->move(storage, other.storage);
+        ops = other.ops;
+        other.ops = nullptr;
+    }
+};
+
+template <typename R, typename... Args, size_t Capacity>
+template <typename Fn>
+const typename InlineFunction<R(Args...), Capacity>::Ops
+    InlineFunction<R(Args...), Capacity>::Model<Fn>::table = {
+        &InlineFunction<R(Args...), Capacity>::Model<Fn>::invoke,
+        &InlineFunction<R(Args...), Capacity>::Model<Fn>::move,
+        &InlineFunction<R(Args...), Capacity>::Model<Fn>::destroy
+    };
+
+#endif
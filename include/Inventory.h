@@ -17,6 +17,8 @@ struct InventoryNode {
 class Inventory {
 public:
     Inventory();
+    Inventory(const Inventory& other);   // deep copy (used by undo snapshots)
+    Inventory& operator=(const Inventory& other);
     ~Inventory();
     
     bool addItem(const std::string& name, const std::string& type, int effect, int quantity = 1);
@@ -0,0 +1,114 @@
+#ifndef MODIFIERPOOL_H
+#define MODIFIERPOOL_H
+
+#include "DaySchedule.h"
+#include "Stats.h"
+#include "StatsBlock.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// What happens when a modifier is applied to a target that already has it
+enum class Stacking : uint8_t {
+    Refresh,       // one instance; the duration restarts
+    Stack,         // one instance; adds a stack up to maxStacks and restarts the duration
+    Independent    // every application runs out on its own
+};
+
+// How a modifier's effect fades over its duration
+enum class Decay : uint8_t {
+    None,          // full effect every step
+    Linear,        // falls evenly to 1/duration of the effect on the last step
+    Halving        // halves every step
+};
+
+// A kind of timed modifier, e.g. a wound or being well fed
+struct ModifierType {
+    StatEffect effect;            // per step and stack
+    uint16_t duration = 1;        // steps it is applied for
+    uint16_t maxStacks = 1;       // Stacking::Stack only
+    Stacking stacking = Stacking::Refresh;
+    Decay decay = Decay::None;
+};
+
+// Summed change for one target in a step
+struct TargetEffect {
+    uint32_t target;
+    StatEffect effect;
+};
+
+// ============================================================
+// Timed stat modifiers for many targets in one flat pool.
+// A step is one unit of the pool's clock: call step() once per game day
+// (GameSession does) or once per tick for a faster pool. The sweep merges
+// entries added since the last one into (target, kind) order, adds up
+// each target's active modifiers into one effect, applies it with a
+// single clamp, and compacts away the expired entries in the same pass.
+// Entries are 16 bytes and the pool only grows its vectors, so a steady
+// state with thousands of modifiers does not allocate.
+// ============================================================
+class ModifierPool {
+public:
+    ModifierPool();
+
+    // Kinds are numbered from 0 in definition order; -1 for a zero duration
+    int defineType(const ModifierType& type);
+    const ModifierType* findType(int kind) const;
+
+    void reserve(size_t count);
+
+    // Apply 'kind' to 'target'; it first takes effect in the next step.
+    // Fails for an unknown kind.
+    bool add(uint32_t target, int kind);
+
+    // Drop every modifier of 'kind' on 'target'; returns how many
+    size_t remove(uint32_t target, int kind);
+
+    // Stacks of 'kind' active on 'target' (instances for Independent)
+    int count(uint32_t target, int kind) const;
+
+    // Advance one step. Returns each affected target's summed effect,
+    // in target order; valid until the next call.
+    const std::vector<TargetEffect>& step();
+
+    // Advance one step and apply it to a single target's stats, or to
+    // the wolves of a pack by index
+    void step(Stats& stats, uint32_t target = 0);
+    void step(StatsBlock& pack);
+
+    size_t size() const;
+
+    // The active modifiers by absolute step, 'now' being the current one
+    // (the game day for GameSession), for saving a position. restore()
+    // replaces the active modifiers with saved ones and skips entries
+    // whose kind is unknown or that have run out by 'now'.
+    void save(std::vector<DayModifier>& out, int now) const;
+    void restore(const std::vector<DayModifier>& saved, int now);
+
+    // Drop all modifiers; defined kinds are kept
+    void clear();
+
+private:
+    struct Modifier {
+        uint32_t target;
+        uint16_t kind;
+        uint16_t stacks;
+        uint16_t age;            // steps applied so far
+        uint16_t remaining;      // steps left
+        uint32_t order;          // application order, keeps the sort stable
+    };
+
+    std::vector<ModifierType> types;
+    std::vector<StatEffect> curves;        // per-stack effect by age, for every kind
+    std::vector<uint32_t> curveStart;      // by kind
+    std::vector<Modifier> active;
+    std::vector<Modifier> merged;    // scratch for sort()
+    std::vector<TargetEffect> totals;
+    size_t sorted;               // active[0, sorted) is in (target, kind) order
+    uint32_t nextOrder;
+
+    Modifier* find(uint32_t target, uint16_t kind);
+    void sort();
+};
+
+#endif
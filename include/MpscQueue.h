@@ -0,0 +1,82 @@
+#ifndef MPSCQUEUE_H
+#define MPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+// ============================================================
+// Bounded lock-free queue for many producer threads and one consumer.
+// Each cell carries a sequence number that tells producers whether it
+// is free for their ticket and tells the consumer whether it has been
+// filled, so there are no locks and a full queue is reported at once
+// instead of blocking. Capacity is rounded up to a power of two.
+// ============================================================
+template <typename T>
+class MpscQueue {
+public:
+    explicit MpscQueue(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) size *= 2;
+        mask = size - 1;
+        cells.reset(new Cell[size]);
+        for (size_t i = 0; i < size; ++i) cells[i].sequence.store(i, std::memory_order_relaxed);
+        enqueuePos.store(0, std::memory_order_relaxed);
+        dequeuePos = 0;
+    }
+
+    // Any thread. False when the queue is full.
+    bool push(const T& item) {
+        size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells[pos & mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+        cell->value = item;
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer thread only. False when nothing is ready.
+    bool pop(T& out) {
+        Cell* cell = &cells[dequeuePos & mask];
+        size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        if (static_cast<intptr_t>(sequence) - static_cast<intptr_t>(dequeuePos + 1) < 0) return false;
+
+        out = std::move(cell->value);
+        cell->sequence.store(dequeuePos + mask + 1, std::memory_order_release);
+        ++dequeuePos;
+        return true;
+    }
+
+    size_t capacity() const { return mask + 1; }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    size_t mask;
+
+    // Producers and the consumer write different cache lines
+    alignas(64) std::atomic<size_t> enqueuePos;
+    alignas(64) size_t dequeuePos;
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+};
+
+#endif
@@ -1,57 +1,89 @@
 #ifndef NODE_H
 #define NODE_H
 
-#include <string>
-#include <vector>
+#include <string_view>
 #include "Event.h"
+#include "NodeStore.h"
 
 // ============================================================
-// IMPORTANT: Choice struct MUST be defined here, not forward declared!
+// Node and Choice are lightweight views into the flat NodeStore
+// tables owned by DecisionTree. They are cheap to copy and stay
+// valid until the story is rebuilt or reloaded; the same holds for
+// the string_views they return, which point into the story's
+// interned string pool.
 // ============================================================
 
-// Choice structure with stat effects (moved from DecisionTree.h)
-struct Choice {
-    std::string text;
-    int targetNodeId;
-    std::vector<StatEffect> effects;
-    
-    Choice(const std::string& t, int target, const std::vector<StatEffect>& eff = {})
-        : text(t), targetNodeId(target), effects(eff) {}
+// Choice with stat effect payload
+class Choice {
+public:
+    Choice(const NodeStore* store, uint32_t index);
+
+    std::string_view getText() const;
+    int getTargetNodeId() const;
+    uint32_t getTargetIndex() const;   // dense node index, always valid
+    EffectRange getEffects() const;
+
+    // All effects summed, precomputed when the story is built; a choice
+    // applies as this one effect
+    StatEffect getEffect() const;
+
+private:
+    const NodeStore* store;
+    uint32_t index;
 };
 
-// ============================================================
-// Node class
-// ============================================================
+// Choices of one node
+class ChoiceRange {
+public:
+    class iterator {
+    public:
+        iterator(const NodeStore* s, uint32_t i) : store(s), index(i) {}
+        Choice operator*() const { return Choice(store, index); }
+        iterator& operator++() { ++index; return *this; }
+        bool operator!=(const iterator& other) const { return index != other.index; }
+        bool operator==(const iterator& other) const { return index == other.index; }
+    private:
+        const NodeStore* store;
+        uint32_t index;
+    };
+
+    ChoiceRange(const NodeStore* store, uint32_t first, uint32_t count);
+
+    iterator begin() const { return iterator(store, first); }
+    iterator end() const { return iterator(store, first + count); }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    Choice operator[](size_t i) const { return Choice(store, first + static_cast<uint32_t>(i)); }
+
+private:
+    const NodeStore* store;
+    uint32_t first;
+    uint32_t count;
+};
 
 class Node {
 public:
-    Node(int id, const std::string& text, bool isEnding = false);
-    
+    Node();
+    Node(const NodeStore* store, uint32_t index);
+
+    bool isValid() const;
+    uint32_t getIndex() const;
+
     int getId() const;
-    std::string getText() const;
+    std::string_view getText() const;
     bool isEndingNode() const;
-    std::string getEndingType() const;
-    
-    // Support for Choice struct with effects
-    void addChoice(const std::string& text, int nextNodeId, const std::vector<StatEffect>& effects = {});
-    void addTrigger(int eventId);
-    void setEndingType(const std::string& type);
-    
-    // Return Choice structs instead of pairs
-    const std::vector<Choice>& getChoicesWithEffects() const;
-    
-    // Legacy support - returns pairs for backward compatibility
-    std::vector<std::pair<std::string, int>> getChoices() const;
-    
-    const std::vector<int>& getTriggers() const;
+    std::string_view getEndingType() const;
+
+    // Non-allocating iteration over the node's choices
+    ChoiceRange getChoicesWithEffects() const;
+
+    ArrayView<int32_t> getTriggers() const;
 
 private:
-    int id;
-    std::string text;
-    bool ending;
-    std::string endingType;
-    std::vector<Choice> choicesWithEffects;  // Uses Choice struct defined above
-    std::vector<int> triggers;
+    const NodeStore* store;
+    uint32_t index;
+
+    const StoryFormat::NodeRecord& record() const;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,186 @@
+#ifndef NODESTORE_H
+#define NODESTORE_H
+
+#include "Event.h"
+#include "StoryFormat.h"
+#include "StringPool.h"
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+class StoryImage;
+
+// Read-only view over a contiguous array
+template <typename T>
+class ArrayView {
+public:
+    ArrayView() : first(nullptr), count(0) {}
+    ArrayView(const T* data, size_t size) : first(data), count(size) {}
+
+    const T* begin() const { return first; }
+    const T* end() const { return first + count; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    const T& operator[](size_t i) const { return first[i]; }
+
+private:
+    const T* first;
+    size_t count;
+};
+
+// Conversions between the on-disk effect record and StatEffect
+StatEffect toStatEffect(const StoryFormat::EffectRecord& record);
+StoryFormat::EffectRecord toEffectRecord(const StatEffect& effect);
+
+// Effect records converted to StatEffect on access
+class EffectRange {
+public:
+    class iterator {
+    public:
+        explicit iterator(const StoryFormat::EffectRecord* p) : current(p) {}
+        StatEffect operator*() const;
+        iterator& operator++() { ++current; return *this; }
+        bool operator!=(const iterator& other) const { return current != other.current; }
+        bool operator==(const iterator& other) const { return current == other.current; }
+    private:
+        const StoryFormat::EffectRecord* current;
+    };
+
+    EffectRange(const StoryFormat::EffectRecord* data, size_t size) : first(data), count(size) {}
+
+    iterator begin() const { return iterator(first); }
+    iterator end() const { return iterator(first + count); }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    StatEffect operator[](size_t i) const { return *iterator(first + i); }
+
+private:
+    const StoryFormat::EffectRecord* first;
+    size_t count;
+};
+
+// Choice whose target did not resolve at finalize(). It is left out of
+// the packed choice table and restored if building is resumed.
+struct DanglingChoice {
+    uint32_t owner;                    // dense index of the owning node
+    uint32_t slot;                     // position among the node's authored choices
+    StoryFormat::ChoiceRecord record;
+};
+
+// ============================================================
+// Flat story storage: one contiguous table each for nodes, choices,
+// effects and triggers, plus a string blob. Nodes are addressed by
+// dense index; author IDs are remapped through a direct table (or a
+// binary search over the id-sorted node table when IDs are sparse).
+//
+// The tables are either owned (built with addNode/addChoice/... and
+// packed by finalize()) or point straight into a mapped StoryImage.
+// Every choice in the packed tables has a valid target index.
+// ============================================================
+class NodeStore {
+public:
+    NodeStore();
+
+    // ---- Building ----
+    void clear();
+    void addNode(int id, std::string_view text, bool isEnding);
+    bool addChoice(int nodeId, std::string_view text, int targetNodeId, const std::vector<StatEffect>& effects);
+    bool addTrigger(int nodeId, int eventId);
+    bool setEndingType(int nodeId, std::string_view type);
+    bool removeNode(int id);   // with its choices and triggers
+
+    // Resume building on top of the current tables (copies a mapped image)
+    void edit();
+
+    // Sort nodes by id, group choices/triggers per node and resolve choice
+    // targets; choices with unknown targets are set aside as dangling
+    void finalize();
+    bool isFinalized() const;
+
+    // Build problems, kept until clear()
+    const std::vector<DanglingChoice>& getDanglingChoices() const;
+    const std::vector<int>& getUnknownNodeRefs() const;   // owners passed to addChoice/... that did not exist
+
+    // Use the tables of a mapped image in place (no copies)
+    void bind(const StoryImage& image);
+
+    // Share another finalized store's tables read-only. The source must
+    // outlive this store and must not be modified while shared.
+    void bind(const NodeStore& source);
+
+    // ---- Lookup (valid once finalized or bound) ----
+    uint32_t findIndex(int id) const;   // StoryFormat::NO_INDEX if unknown
+    uint32_t getNodeCount() const;
+    uint32_t getChoiceCount() const;
+    uint32_t getEffectCount() const;
+    uint32_t getTriggerCount() const;
+
+    const StoryFormat::NodeRecord& getNode(uint32_t index) const;
+    const StoryFormat::ChoiceRecord& getChoice(uint32_t index) const;
+    const StoryFormat::EffectRecord* getEffects() const;
+    const int32_t* getTriggers() const;
+    const char* getStrings() const;
+    size_t getStringSize() const;
+    std::string_view getString(uint32_t offset, uint32_t length) const;
+
+    // Approximate bytes used by the tables
+    size_t getMemoryUsage() const;
+
+    bool writeImage(const std::string& filename) const;
+
+private:
+    struct StagedChoice {
+        uint32_t owner;
+        StoryFormat::ChoiceRecord record;
+    };
+    struct StagedTrigger {
+        uint32_t owner;
+        int32_t eventId;
+    };
+
+    // Staging area used while building (author order, any interleaving)
+    std::unordered_map<int, uint32_t> buildIndex;
+    std::vector<StagedChoice> stagedChoices;
+    std::vector<StagedTrigger> stagedTriggers;
+    std::vector<DanglingChoice> danglingChoices;
+    std::vector<int> unknownNodeRefs;
+    std::vector<uint32_t> removedNodes;    // staging indices dropped at finalize()
+
+    // Owned tables
+    std::vector<StoryFormat::NodeRecord> ownedNodes;
+    std::vector<StoryFormat::ChoiceRecord> ownedChoices;
+    std::vector<StoryFormat::EffectRecord> ownedEffects;
+    std::vector<int32_t> ownedTriggers;
+    std::vector<uint32_t> ownedIdTable;
+    StringPool ownedStrings;    // all story text, interned
+
+    // Active tables (owned or mapped)
+    const StoryFormat::NodeRecord* nodes;
+    const StoryFormat::ChoiceRecord* choices;
+    const StoryFormat::EffectRecord* effects;
+    const int32_t* triggers;
+    const uint32_t* idTable;
+    const char* strings;
+    uint32_t nodeCount;
+    uint32_t choiceCount;
+    uint32_t effectCount;
+    uint32_t triggerCount;
+    int32_t idBase;
+    uint32_t idTableSize;
+    size_t stringSize;
+
+    bool finalized;
+    bool mapped;    // tables are borrowed (mapped image or shared store)
+    bool reopened;  // finalize() compacts effects and strings
+
+    uint32_t stagingIndex(int id);
+    void reopen();
+    void dropRemoved();
+    void compact();
+    void bindOwned();
+    uint32_t appendString(std::string_view s);
+};
+
+#endif
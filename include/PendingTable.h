@@ -0,0 +1,90 @@
+#ifndef PENDINGTABLE_H
+#define PENDINGTABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// ============================================================
+// Open-addressing map from a non-zero 64-bit event key to the state of
+// its queued occurrence: how many triggers were merged into it and the
+// tick it may be dispatched at. Linear probing with backward-shift
+// erase, so there are no tombstones and lookups stay short.
+// ============================================================
+class PendingTable {
+public:
+    struct Entry {
+        uint64_t key = 0;       // 0 marks an empty slot
+        uint32_t count = 0;
+        uint32_t readyTick = 0;
+    };
+
+    PendingTable() : used(0) {}
+
+    // Key 0 is never stored, so it always misses
+    Entry* find(uint64_t key) {
+        if (used == 0 || key == 0) return nullptr;
+        const size_t mask = slots.size() - 1;
+        for (size_t i = home(key); ; i = (i + 1) & mask) {
+            if (slots[i].key == key) return &slots[i];
+            if (slots[i].key == 0) return nullptr;
+        }
+    }
+
+    // 'key' must not be present
+    void insert(uint64_t key, uint32_t readyTick) {
+        if ((used + 1) * 4 > slots.size() * 3) grow();
+        const size_t mask = slots.size() - 1;
+        size_t i = home(key);
+        while (slots[i].key != 0) i = (i + 1) & mask;
+        slots[i].key = key;
+        slots[i].count = 1;
+        slots[i].readyTick = readyTick;
+        ++used;
+    }
+
+    void erase(Entry* entry) {
+        const size_t mask = slots.size() - 1;
+        size_t hole = static_cast<size_t>(entry - slots.data());
+        // Pull back later entries whose probe chain crosses the hole
+        for (size_t i = (hole + 1) & mask; slots[i].key != 0; i = (i + 1) & mask) {
+            size_t want = home(slots[i].key);
+            if (((i - want) & mask) >= ((i - hole) & mask)) {
+                slots[hole] = slots[i];
+                hole = i;
+            }
+        }
+        slots[hole] = Entry();
+        --used;
+    }
+
+    void clear() {
+        for (Entry& entry : slots) entry = Entry();
+        used = 0;
+    }
+
+    size_t size() const { return used; }
+
+private:
+    std::vector<Entry> slots;   // power-of-two size, at most 3/4 full
+    size_t used;
+
+    size_t home(uint64_t key) const {
+        return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> 32) & (slots.size() - 1);
+    }
+
+    void grow() {
+        std::vector<Entry> old;
+        old.swap(slots);
+        slots.resize(old.empty() ? 64 : old.size() * 2);
+        const size_t mask = slots.size() - 1;
+        for (const Entry& entry : old) {
+            if (entry.key == 0) continue;
+            size_t i = home(entry.key);
+            while (slots[i].key != 0) i = (i + 1) & mask;
+            slots[i] = entry;
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef PLAYTHROUGHANALYZER_H
+#define PLAYTHROUGHANALYZER_H
+
+#include "DecisionTree.h"
+#include <cstdint>
+#include <vector>
+
+enum class PlayPolicy {
+    Random,        // uniform over the available choices
+    FirstChoice,   // always choice A
+    Scripted       // follow script, then continue at random
+};
+
+struct AnalyzerConfig {
+    uint64_t playthroughs = 100000;
+    unsigned int threads = 0;        // 0 = one per hardware thread
+    uint64_t seed = 1;
+    PlayPolicy policy = PlayPolicy::Random;
+    std::vector<int> script;         // choice indices for PlayPolicy::Scripted
+    int maxSteps = 1000;             // guards against cyclic stories
+    uint32_t chunkSize = 256;        // playthroughs per scheduling unit
+};
+
+// Final value distribution of one stat (values clamped to 0..BUCKETS-1)
+struct StatHistogram {
+    static const int BUCKETS = 128;
+    uint64_t counts[BUCKETS] = {};
+    uint64_t sum = 0;
+    int64_t minValue = INT64_MAX;
+    int64_t maxValue = INT64_MIN;
+
+    void add(int value);
+    void merge(const StatHistogram& other);
+    double mean(uint64_t samples) const;
+    int percentile(double p) const;
+};
+
+struct AnalyzerReport {
+    enum Stat { HEALTH, HUNGER, STAMINA, PACK_STATUS, MORALE, STRENGTH, XP, STAT_COUNT };
+
+    uint64_t playthroughs = 0;
+    uint64_t deaths = 0;                 // Stats::isDead() before reaching an ending
+    uint64_t stalled = 0;                // no choices left or maxSteps hit
+    std::vector<uint64_t> endingCounts;  // by dense node index
+    uint64_t totalDays = 0;
+    int maxDays = 0;
+    StatHistogram stats[STAT_COUNT];
+    unsigned int threads = 0;
+    double seconds = 0.0;
+};
+
+// ============================================================
+// Monte Carlo playthrough analyzer.
+// Runs independent GameSessions on all cores. Work is split into
+// chunks distributed with a lock-free work-stealing scheduler; each
+// playthrough seeds its own RNG from (seed, index), so results do not
+// depend on scheduling. Each thread fills a private report that is
+// merged once at the end.
+// ============================================================
+namespace PlaythroughAnalyzer {
+    AnalyzerReport run(const DecisionTree& story, const AnalyzerConfig& config);
+}
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef STATHISTORY_H
+#define STATHISTORY_H
+
+#include "Stats.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ============================================================
+// Fixed-memory time series of all seven stats (.wsh when saved).
+// Samples go into a ring of CAPACITY buckets; every FACTOR buckets of
+// a level are merged into one bucket of the next, which keeps min, max
+// and sum, so level L holds CAPACITY buckets of FACTOR^L samples each.
+// Memory never grows, fine detail is kept for recent samples and the
+// top level still spans CAPACITY * FACTOR^(LEVELS-1) samples. plot()
+// reads the finest level that covers the history, so drawing costs at
+// most CAPACITY + 1 points however long the session ran.
+//
+//   Header | per level: uint32 count, Bucket[count] (oldest first)
+// ============================================================
+class StatSeries {
+public:
+    static const int LEVELS = 8;
+    static const int FACTOR = 4;
+    static const int CAPACITY = 128;
+    static const int PLOT_POINTS = CAPACITY + 1;
+
+    static const uint32_t MAGIC = 0x31485357;    // "WSH1" little-endian
+    static const uint32_t VERSION = 1;
+
+    struct Bucket {
+        int32_t min[STAT_COUNT];
+        int32_t max[STAT_COUNT];
+        int64_t sum[STAT_COUNT];
+        uint32_t count;          // samples merged into the bucket
+        uint64_t first;          // index of its first sample
+    };
+
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint16_t levels;
+        uint16_t factor;
+        uint16_t capacity;
+        uint16_t statCount;
+        uint64_t samples;
+    };
+
+    StatSeries();
+
+    void record(const Stats& stats);
+    uint64_t getSampleCount() const;
+    void clear();
+
+    // Average, min and max of 'stat' per point, oldest first, each array
+    // PLOT_POINTS long. Returns the number of points written.
+    int plot(StatId stat, float* avg, float* min, float* max) const;
+
+    // Buckets of one level, oldest first
+    int getBucketCount(int level) const;
+    const Bucket& getBucket(int level, int index) const;
+
+    // One row per completed bucket of every level, coarsest first:
+    // level, first, count, then min/avg/max of each stat
+    bool exportCsv(const std::string& path, std::string& error) const;
+
+    // Raw buckets in the layout above; load() reads them back
+    bool exportBinary(const std::string& path, std::string& error) const;
+    bool load(const std::string& path, std::string& error);
+
+private:
+    std::vector<Bucket> rings;      // LEVELS rings of CAPACITY buckets
+    int head[LEVELS];               // next slot to write
+    int size[LEVELS];
+    Bucket partial[LEVELS];         // level L collects level L-1 buckets; unused for 0
+    int merged[LEVELS];             // buckets in partial[L]
+    uint64_t samples;
+
+    void push(int level, const Bucket& bucket);
+    int coveringLevel() const;
+};
+
+// The session's stat history: one series per game day, one per tick
+struct StatHistory {
+    StatSeries days;
+    StatSeries ticks;
+
+    void clear() {
+        days.clear();
+        ticks.clear();
+    }
+};
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef STATRULES_H
+#define STATRULES_H
+
+#include "Stats.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+enum class Comparator : uint8_t {
+    Below,   // fires when the stat drops under the threshold
+    Above    // fires when the stat rises over the threshold
+};
+
+// One row of the rule table. Priority, description and effect come
+// from the registered event the rule triggers.
+struct StatRule {
+    StatId stat = StatId::Health;
+    Comparator comparator = Comparator::Below;
+    int threshold = 0;
+    int hysteresis = 0;   // distance back past the threshold that re-arms the rule
+    int eventId = 0;
+};
+
+// Stats of many entities, one column per StatId
+struct StatColumns {
+    const int* values[STAT_COUNT];
+    size_t count;
+};
+
+// ============================================================
+// Edge-triggered threshold rules. A rule fires once when its condition
+// becomes true and stays quiet until the stat moves back past the
+// threshold by the hysteresis margin. compile() turns the table into
+// flat arrays with every comparison rewritten as "x < level", so
+// evaluate() is one branch-free pass per rule over all entities.
+// ============================================================
+class StatRuleSet {
+public:
+    StatRuleSet();
+
+    void add(const StatRule& rule);
+    void compile();
+    void clear();
+
+    size_t size() const;
+    const StatRule& getRule(size_t index) const;
+    int getEventId(size_t index) const;
+
+    // 'armed' and 'fired' hold size() * stats.count flags, rule-major
+    // (rule r, entity e at r * count + e). 'armed' starts at 1 and is
+    // updated in place; 'fired' is overwritten. Returns the fire count.
+    size_t evaluate(const StatColumns& stats, uint8_t* armed, uint8_t* fired) const;
+
+    // Derive 'armed' from the current values alone: a rule whose
+    // condition already holds is treated as having fired. Inside the
+    // hysteresis band the flag depends on history, so this is only a
+    // guess there; keep the flags themselves where they must be exact.
+    void sync(const StatColumns& stats, uint8_t* armed) const;
+
+private:
+    std::vector<StatRule> rules;
+
+    // Compiled form: x = sign * value; fire when x < fireLevel, re-arm
+    // when x >= rearmLevel
+    std::vector<uint8_t> column;
+    std::vector<int> sign;
+    std::vector<int> fireLevel;
+    std::vector<int> rearmLevel;
+    bool compiled;
+};
+
+#endif
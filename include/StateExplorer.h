@@ -0,0 +1,82 @@
+#ifndef STATEEXPLORER_H
+#define STATEEXPLORER_H
+
+#include "DecisionTree.h"
+#include "Stats.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct ExplorerConfig {
+    uint64_t maxStates = 50000000;   // stop (and report truncated) beyond this
+    bool randomEncounters = true;    // branch on every encounter outcome
+};
+
+// Packed game state: seven 7-bit stats and a 15-bit inventory mask in
+// one word, plus the dense node index and the event state (the armed
+// flag of each stat rule and the follow-ups pending) in what would
+// otherwise be padding.
+struct PackedState {
+    static const int STAT_BITS = 7;
+    static const int STAT_COUNT = 7;
+    static const int STAT_MAX = (1 << STAT_BITS) - 1;   // XP saturates here
+    static const int INVENTORY_BITS = 15;               // distinct item kinds
+    static const int EVENT_BITS = 32;
+
+    uint64_t bits;
+    uint32_t node;
+    uint32_t events;    // rule flags, then follow-ups due (StateExplorer.cpp)
+
+    static PackedState pack(uint32_t node, const Stats& stats, uint32_t inventoryMask, uint32_t events = 0);
+    Stats unpackStats() const;
+    int stat(int s) const;
+    uint32_t inventoryMask() const;
+
+    bool operator==(const PackedState& other) const {
+        return bits == other.bits && node == other.node && events == other.events;
+    }
+};
+
+// Range of one stat over all reachable states at a node
+struct StatRange {
+    int minValue = PackedState::STAT_MAX;
+    int maxValue = 0;
+};
+
+struct NodeSummary {
+    uint64_t states = 0;      // distinct reachable states at this node
+    int minDepth = -1;        // fewest choices from the start (-1 = unreachable)
+    StatRange stats[PackedState::STAT_COUNT];
+};
+
+struct ExplorerReport {
+    std::vector<NodeSummary> nodes;          // by dense node index
+    std::vector<uint32_t> reachableEndings;  // dense node indices
+    std::vector<uint32_t> unreachableEndings;
+    std::vector<std::string> items;          // inventory mask bit -> item name
+    uint64_t states = 0;
+    uint64_t transitions = 0;
+    uint64_t deathStates = 0;                // Stats::isDead() before an ending
+    uint64_t xpSaturated = 0;                // states whose XP hit STAT_MAX
+    bool truncated = false;                  // maxStates, item kinds or event bits exceeded
+    size_t memoryBytes = 0;
+    double seconds = 0.0;
+};
+
+// ============================================================
+// Exhaustive explorer over (node, stats, inventory, events) states.
+// Stats are clamped to 0..100 and XP is saturated, so the state space
+// is finite. Transitions are produced by a GameSession (one per choice
+// and encounter outcome) and deduplicated in an open-addressing table
+// of indices into the state list, which doubles as the BFS queue.
+// Rule flags are part of a state because a rule inside its hysteresis
+// band may or may not fire again depending on how the stat got there;
+// so are follow-ups still to come, as days ahead. The day counter
+// itself never affects a transition and is not part of a state; item
+// quantities are not either (only held/not held is).
+// ============================================================
+namespace StateExplorer {
+    ExplorerReport run(const DecisionTree& story, const ExplorerConfig& config = ExplorerConfig());
+}
+
+#endif
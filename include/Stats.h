@@ -18,12 +18,18 @@ public:
     int getStrength() const;
     int getXP() const;
 
+    int getStat(StatId stat) const;
+
+    // Every stat at once, e.g. to take the difference of two states
+    StatEffect getValues() const;
+
     void applyEffect(const StatEffect& effect);
     void reset();
     bool isDead() const;
     bool canMakeChoice() const;
     
-    // Validate and clamp stats (as described in Listing 6.1)
+    // Clamp stats (as described in Listing 6.1); the penalties for low
+    // stamina and morale are timed modifiers, stepped just before it
     void validateStats();
 
     // Setters
@@ -36,15 +42,11 @@ public:
     void addXP(int value);
 
 private:
-    int health;
-    int hunger;
-    int stamina;
-    int packStatus;
-
-    int morale;
-    int strength;
-    int xp;
+    // One lane per StatId, laid out like StatEffect so applyEffect is a
+    // vector add and clamp; the spare lane stays 0
+    int32_t values[StatEffect::LANES];
 
+    int& at(StatId stat) { return values[static_cast<int>(stat)]; }
     void clamp(int& value, int min, int max);
 };
 
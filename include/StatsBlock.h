@@ -0,0 +1,61 @@
+#ifndef STATSBLOCK_H
+#define STATSBLOCK_H
+
+#include "Stats.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Instruction sets StatsBlock can use, best last
+enum class SimdLevel {
+    Scalar,
+    SSE2,
+    AVX2
+};
+
+// ============================================================
+// Stats of many wolves stored column by column (structure of arrays).
+// The six 0..100 stats are one byte per wolf, so a 32-byte AVX2 vector
+// updates 32 wolves with a saturating add and a min against 100; XP is
+// unbounded and kept as an int column. Results match applying the same
+// effect through Stats::applyEffect to each wolf. The best kernel the
+// CPU supports is picked at startup, with a scalar fallback.
+// ============================================================
+class StatsBlock {
+public:
+    explicit StatsBlock(size_t count = 0);
+
+    // New wolves start with the Stats() defaults
+    void resize(size_t count);
+    size_t size() const;
+
+    void set(size_t index, const Stats& stats);
+    Stats get(size_t index) const;
+    int getStat(size_t index, StatId stat) const;
+
+    // Contiguous column of a clamped stat (not XP), size() bytes
+    uint8_t* column(StatId stat);
+    const uint8_t* column(StatId stat) const;
+    int* xpColumn();
+    const int* xpColumn() const;
+
+    // Add 'effect' to every wolf; columns with a zero change are skipped
+    void applyEffect(const StatEffect& effect);
+
+    // Add deltas[i] to wolf i for one stat (size() entries)
+    void applyDeltas(StatId stat, const int8_t* deltas);
+
+    // Kernel selection; setSimdLevel fails for a level the CPU lacks
+    static SimdLevel getSimdLevel();
+    static bool setSimdLevel(SimdLevel level);
+    static const char* getSimdName(SimdLevel level);
+
+private:
+    static const int CLAMPED_COUNT = STAT_COUNT - 1;   // every stat but XP
+
+    std::vector<uint8_t> lanes[CLAMPED_COUNT];
+    std::vector<int> xp;
+    size_t count;
+};
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef STORYFORMAT_H
+#define STORYFORMAT_H
+
+#include <cstdint>
+
+// ============================================================
+// Compiled story image layout (.wsb)
+// Produced by storyc from a text story and mapped read-only by StoryImage.
+// Every reference is an offset from the start of the image, so the file
+// is relocatable and can be used in place without any fix-ups.
+//
+//   Header | NodeRecord[] | ChoiceRecord[] | EffectRecord[] |
+//   int32 triggers[] | uint32 idTable[] | string blob
+// ============================================================
+
+namespace StoryFormat {
+
+const uint32_t MAGIC = 0x31425357;        // "WSB1" little-endian
+const uint32_t VERSION = 2;           // 2: ChoiceRecord::foldedEffect
+const uint32_t NO_INDEX = 0xFFFFFFFFu;
+const uint32_t SECTION_ALIGN = 8;
+
+// Node flags
+const uint32_t NODE_ENDING = 1u << 0;
+
+struct Header {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t fileSize;
+
+    uint32_t nodeCount;
+    uint32_t choiceCount;
+    uint32_t effectCount;
+    uint32_t triggerCount;
+
+    uint64_t nodeOffset;
+    uint64_t choiceOffset;
+    uint64_t effectOffset;
+    uint64_t triggerOffset;
+
+    // Direct id -> node index table covering [idBase, idBase + idTableSize).
+    // idTableSize is 0 when author IDs are too sparse; nodes are then looked
+    // up by binary search (the node table is always sorted by id).
+    uint64_t idTableOffset;
+    int32_t idBase;
+    uint32_t idTableSize;
+
+    uint64_t stringOffset;
+    uint64_t stringSize;
+};
+
+struct NodeRecord {
+    int32_t id;
+    uint32_t flags;
+    uint32_t textOffset;      // into the string blob
+    uint32_t textLength;
+    uint32_t endingOffset;
+    uint32_t endingLength;
+    uint32_t firstChoice;
+    uint32_t choiceCount;
+    uint32_t firstTrigger;
+    uint32_t triggerCount;
+};
+
+struct ChoiceRecord {
+    uint32_t textOffset;
+    uint32_t textLength;
+    int32_t targetNodeId;
+    uint32_t targetIndex;     // dense index of the target node, never NO_INDEX
+    uint32_t firstEffect;
+    uint32_t effectCount;
+    uint32_t foldedEffect;    // sum of the choice's effects, NO_INDEX if none
+};
+
+struct EffectRecord {
+    int32_t health;
+    int32_t hunger;
+    int32_t stamina;
+    int32_t packStatus;
+    int32_t morale;
+    int32_t strength;
+    int32_t xp;
+};
+
+}
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef STORYGENERATOR_H
+#define STORYGENERATOR_H
+
+#include "DecisionTree.h"
+#include "StoryParser.h"
+#include <cstdint>
+#include <functional>
+#include <string>
+
+struct GeneratorConfig {
+    uint32_t nodeCount = 1000;
+    int branching = 2;            // choices per non-ending node
+    double endingRatio = 0.1;     // share of nodes that are endings
+    double cycleDensity = 0.05;   // share of extra choices that lead back
+    int effectsPerChoice = 1;
+    int triggersPerNode = 1;      // event IDs 1..10, as registered by GameSession
+    int textWords = 24;           // words of story text per node
+    int window = 64;              // forward choices land within this many nodes
+    uint64_t seed = 1;
+};
+
+// ============================================================
+// Synthetic stories for scaling tests. Node 1 is the start and every
+// node is reachable from it: each node is first linked from the
+// closest non-ending node before it, then the remaining choices go to
+// random nodes ahead (or, with cycleDensity, behind). The last node is
+// always an ending, so no non-ending node is left without choices.
+// ============================================================
+namespace StoryGenerator {
+    // Produce the node definitions in id order without building anything
+    void generateNodes(const GeneratorConfig& config, const std::function<void(const StoryNodeDef&)>& onNode);
+
+    // Build through DecisionTree's builder API (finalizes the tree)
+    void generate(DecisionTree& tree, const GeneratorConfig& config);
+
+    // Write the same story as text source (see StoryParser.h)
+    bool writeSource(const std::string& filename, const GeneratorConfig& config);
+}
+
+#endif
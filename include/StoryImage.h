@@ -0,0 +1,63 @@
+#ifndef STORYIMAGE_H
+#define STORYIMAGE_H
+
+#include "StoryFormat.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Read-only memory mapping of a compiled story image.
+// open() checks only the header and the section bounds, so it takes the
+// same time for any story size; nothing is parsed or copied. Records are
+// checked one node at a time by checkNode() before a reader first uses
+// them, and write() refuses tables that would fail those checks.
+class StoryImage {
+public:
+    StoryImage();
+    ~StoryImage();
+
+    bool open(const std::string& filename);
+    void close();
+    bool isOpen() const;
+
+    const StoryFormat::Header& getHeader() const;
+    const StoryFormat::NodeRecord* getNodes() const;
+    const StoryFormat::ChoiceRecord* getChoices() const;
+    const StoryFormat::EffectRecord* getEffects() const;
+    const int32_t* getTriggers() const;
+    const uint32_t* getIdTable() const;
+    const char* getStrings() const;
+
+    // Node index for an author ID, or StoryFormat::NO_INDEX
+    uint32_t findNode(int id) const;
+
+    // Whether a node's strings, choices and triggers, and each choice's
+    // text, effects and target, stay inside their tables. Costs one pass
+    // over the node's choices.
+    bool checkNode(uint32_t index) const;
+
+    // Serialize tables into an image file (used by storyc)
+    static bool write(const std::string& filename,
+                      const std::vector<StoryFormat::NodeRecord>& nodes,
+                      const std::vector<StoryFormat::ChoiceRecord>& choices,
+                      const std::vector<StoryFormat::EffectRecord>& effects,
+                      const std::vector<int32_t>& triggers,
+                      const std::string& strings);
+
+private:
+    const unsigned char* data;
+    size_t size;
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#else
+    int fileDescriptor;
+#endif
+
+    bool validate() const;
+
+    StoryImage(const StoryImage&) = delete;
+    StoryImage& operator=(const StoryImage&) = delete;
+};
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef STORYPARSER_H
+#define STORYPARSER_H
+
+#include "DecisionTree.h"
+#include "EventManager.h"
+#include <functional>
+#include <istream>
+#include <string>
+#include <vector>
+
+// Reader for the text story format (see stories/wolf.story):
+//
+//   node <id>
+//   text <story text>
+//   ending <ending type>                      (marks the node as an ending)
+//   choice <target> | <text> [| <effect> [; <effect> ...]]
+//   trigger <event id>
+//
+// An effect is up to seven integers in StatEffect order:
+// health hunger stamina packStatus morale strength xp
+//
+// Event data files (see stories/wolf.events) hold one event per line:
+//
+//   event <id> | <LOW|MEDIUM|HIGH|CRITICAL> | <description> [| <effect>]
+//   rule <stat> <'<'|'>'> <threshold> | <hysteresis> | <event id>
+//   followup <event id> | <delay days> | <event id> [| <period days>]
+//   modifier <name> | <duration days> | <effect per day> [| <stacking> [| <decay>]]
+//   apply <event id> | <modifier name>
+//
+// Rule stats: health hunger stamina packStatus morale strength xp
+// Stacking: refresh (default), stack <max stacks>, independent
+// Decay: none (default), linear, halving
+
+// One parsed node block
+struct StoryChoiceDef {
+    std::string text;
+    int target = 0;
+    std::vector<StatEffect> effects;
+};
+
+struct StoryNodeDef {
+    int id = 0;
+    bool ending = false;
+    std::string text;
+    std::string endingType;
+    std::vector<StoryChoiceDef> choices;
+    std::vector<int> triggers;
+};
+
+namespace StoryParser {
+    bool parse(std::istream& in, DecisionTree& tree, std::string& error);
+
+    // Parse node blocks without building anything; 'onNode' gets each
+    // block as it completes. firstLine offsets line numbers in errors.
+    bool parseNodes(std::istream& in, const std::function<void(const StoryNodeDef&)>& onNode,
+                    std::string& error, int firstLine = 1);
+
+    // Add (or redefine) one node through DecisionTree's builder API
+    void addNode(DecisionTree& tree, const StoryNodeDef& node);
+
+    bool loadFile(const std::string& filename, DecisionTree& tree, std::string& error);
+
+    // Load a compiled .wsb image or a text .story source by extension;
+    // an empty path loads the built-in nodes (used by the command-line tools)
+    bool loadStory(const std::string& path, DecisionTree& tree, std::string& error);
+
+    // Register every event, rule, followup and modifier in a data file in one pass and freeze
+    // the registry. Nothing is registered if the file has an error.
+    bool loadEvents(const std::string& filename, EventManager& events, std::string& error);
+}
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef STORYVALIDATOR_H
+#define STORYVALIDATOR_H
+
+#include "NodeStore.h"
+#include <cstdint>
+#include <vector>
+
+// Problems found in a finalized story graph. Nodes are dense indices.
+struct StoryDiagnostics {
+    uint32_t startIndex = StoryFormat::NO_INDEX;      // NO_INDEX if the start node is missing
+    std::vector<DanglingChoice> danglingChoices;     // targets that do not exist
+    std::vector<int> unknownNodeRefs;                // choices/triggers for undefined nodes
+    std::vector<uint32_t> unreachable;               // not reachable from the start node
+    std::vector<uint32_t> sinks;                     // non-ending nodes without choices
+
+    // Strongly connected components that contain a cycle, stored flat:
+    // component c is cycleNodes[cycleStarts[c] .. cycleStarts[c + 1])
+    std::vector<uint32_t> cycleNodes;
+    std::vector<uint32_t> cycleStarts;
+
+    double seconds = 0.0;
+
+    // Missing start, dangling targets, unknown nodes or sinks. Unreachable
+    // nodes and cycles are reported but allowed.
+    bool hasErrors() const;
+    size_t getCycleCount() const;
+};
+
+// ============================================================
+// Linear-time checks over the compiled graph: reachability from the
+// start node (BFS), dead ends, and cycles (iterative Tarjan SCC, so
+// deep stories cannot overflow the call stack).
+// ============================================================
+namespace StoryValidator {
+    StoryDiagnostics validate(const NodeStore& store, int startId);
+}
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef STORYWATCHER_H
+#define STORYWATCHER_H
+
+#include "DecisionTree.h"
+#include "StoryParser.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Node changes between two versions of a story source
+struct StoryPatch {
+    std::vector<StoryNodeDef> nodes;   // added or edited nodes
+    std::vector<int> removed;          // node IDs no longer in the file
+    std::string error;                 // parse error in the latest edit
+
+    bool empty() const { return nodes.empty() && removed.empty() && error.empty(); }
+};
+
+// ============================================================
+// Hot reload of a text story. A background thread polls the file,
+// waits until it has stopped changing (debounce), splits it into node
+// blocks and re-parses only the blocks whose hash changed. The frame
+// loop picks up the finished patch with takePatch(), which never
+// blocks, and applies it with apply().
+// ============================================================
+class StoryWatcher {
+public:
+    explicit StoryWatcher(const std::string& path, int pollMs = 20, int debounceMs = 30);
+    ~StoryWatcher();
+
+    // The first scan only records the current contents as the baseline
+    void start();
+    void stop();
+
+    // Latest pending patch, if any (merged if several edits happened)
+    bool takePatch(StoryPatch& out);
+
+    // Patch the tree in place. The current node ID is kept; if that node
+    // was removed it is left in place. Returns false if nothing changed.
+    static bool apply(DecisionTree& tree, const StoryPatch& patch);
+
+private:
+    std::string path;
+    int pollMs;
+    int debounceMs;
+
+    std::thread worker;
+    std::atomic<bool> running;
+
+    std::mutex pendingMutex;
+    StoryPatch pending;
+    bool hasPending;
+
+    // Worker thread state
+    std::unordered_map<int, uint64_t> blockHashes;   // node ID -> block hash
+
+    void run();
+    void scan(const std::string& contents, bool baseline);
+    void publish(StoryPatch& patch);
+
+    StoryWatcher(const StoryWatcher&) = delete;
+    StoryWatcher& operator=(const StoryWatcher&) = delete;
+};
+
+#endif
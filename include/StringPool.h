@@ -0,0 +1,44 @@
+#ifndef STRINGPOOL_H
+#define STRINGPOOL_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Append-only arena of interned strings.
+// Identical strings are stored once; callers keep (offset, length)
+// pairs, which stay valid as the arena grows.
+class StringPool {
+public:
+    StringPool();
+
+    // Offset of an identical string already in the pool, or of a new copy
+    uint32_t intern(std::string_view s);
+
+    std::string_view get(uint32_t offset, uint32_t length) const;
+    const char* data() const;
+    size_t size() const;
+
+    // Take over an existing blob (e.g. from a mapped image). Its contents
+    // are not indexed, so later interns may store a second copy.
+    void adopt(std::string blob);
+    void clear();
+
+private:
+    struct Slot {
+        uint32_t offset;
+        uint32_t length;
+        uint32_t hash;
+        bool used;
+    };
+
+    std::string arena;
+    std::vector<Slot> slots;
+    size_t usedSlots;
+
+    static uint32_t hashOf(std::string_view s);
+    void grow();
+};
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Handle to a scheduled timer; stale after it fires or is cancelled
+struct TimerId {
+    uint32_t index = 0xFFFFFFFFu;
+    uint32_t generation = 0;
+};
+
+// ============================================================
+// Hierarchical timer wheel: four levels of 64 slots, each level 64
+// times coarser than the one below. A timer sits in the level that
+// matches its distance from now and moves down one level each time
+// that level's slot comes round, so schedule and cancel are O(1) and
+// advancing only touches slots that are due. Timers further out than
+// the top level wait in an overflow list. Time is an abstract tick
+// count (game days or milliseconds; see EventManager).
+// ============================================================
+class TimerWheel {
+public:
+    static const int SLOT_BITS = 6;
+    static const int SLOTS = 1 << SLOT_BITS;
+    static const int LEVELS = 4;
+
+    // A scheduled timer as reported by getPending()
+    struct Pending {
+        uint64_t expires;
+        uint64_t period;
+        int eventId;
+    };
+
+    TimerWheel();
+
+    // Fire 'eventId' after 'delay' ticks (at least 1), then every
+    // 'period' ticks if period > 0
+    TimerId schedule(uint64_t delay, uint64_t period, int eventId);
+    bool cancel(TimerId id);
+
+    // Move time forward to 'now', appending the event of every timer
+    // that expires on the way to 'expired' in expiry order
+    void advance(uint64_t now, std::vector<int>& expired);
+
+    uint64_t getTime() const;
+    size_t size() const;
+
+    // Every scheduled timer, in no particular order (e.g. to save them
+    // and schedule them again after clear())
+    void getPending(std::vector<Pending>& out) const;
+
+    // Cancel everything and restart time at 'now'
+    void clear(uint64_t now = 0);
+
+private:
+    static const uint32_t NONE = 0xFFFFFFFFu;
+
+    struct Timer {
+        uint64_t expires = 0;
+        uint64_t period = 0;
+        int eventId = 0;
+        uint32_t prev = NONE;
+        uint32_t next = NONE;
+        uint32_t generation = 0;
+        uint16_t list = 0;      // slot list the timer is linked into
+        bool active = false;
+    };
+
+    std::vector<Timer> timers;
+    std::vector<uint32_t> freeTimers;
+    uint32_t heads[LEVELS * SLOTS + 1];   // last list is the overflow
+    uint64_t occupied[LEVELS];            // bit per non-empty slot
+    uint64_t current;
+    size_t count;
+
+    void place(uint32_t index);
+    void link(uint32_t index, int list);
+    void unlink(uint32_t index);
+    void cascade(int level);
+};
+
+#endif
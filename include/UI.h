@@ -5,7 +5,9 @@
 #include "Event.h"
 #include "GameState.h"
 #include "ActionQueue.h"
+#include "StatHistory.h"
 #include <string>
+#include <string_view>
 #include <vector>
 
 // Forward declaration for GLFW
@@ -15,16 +17,19 @@ struct GLFWwindow;
 namespace UIManager {
     // Core rendering methods
     void render(GameState& state, DecisionTree& story, std::vector<Event>& eventLog, 
-                int& selectedChoice, GameStateStack& history, ActionQueue& actionQueue);
+                int& selectedChoice, GameStateStack& history, ActionQueue& actionQueue,
+                const StatHistory* statHistory = nullptr);
     
     // NEW: ESC key handler to close the window
     void checkEscapeKey(GLFWwindow* window);
     
     // Individual panels (as described in Ch 7)
-    void displayStatsPanel(const Stats& stats, int day, int packSize, const std::string& weather);
-    void displayNodeGUI(const Node* node, int& selectedChoice);
+    // With a StatHistory, also plots each stat's trend and offers export
+    void displayStatsPanel(const Stats& stats, int day, int packSize, std::string_view weather,
+                           const StatHistory* statHistory = nullptr);
+    void displayNodeGUI(const Node& node, int& selectedChoice);
     void showInventoryGUI(Inventory* inventory, Stats& stats);
-    void displayEventGUI(const std::string& text);
+    void displayEventGUI(std::string_view text);
     void displayEventLog(const std::vector<Event>& events);
     
     // Action controls panel for undo/redo
@@ -32,7 +37,7 @@ namespace UIManager {
                                bool& undoRequested, bool& clearHistoryRequested);
     
     bool displayWelcomeScreen(bool& startGame);
-    void displayEndingGUI(const std::string& text);
+    void displayEndingGUI(std::string_view text);
 }
 
 // Backward compatibility
@@ -41,16 +46,17 @@ public:
     static void checkEscapeKey(GLFWwindow* window) {
         UIManager::checkEscapeKey(window);
     }
-    static void displayStatsPanel(const Stats& stats, int day, int packSize, const std::string& weather) {
-        UIManager::displayStatsPanel(stats, day, packSize, weather);
+    static void displayStatsPanel(const Stats& stats, int day, int packSize, std::string_view weather,
+                                  const StatHistory* statHistory = nullptr) {
+        UIManager::displayStatsPanel(stats, day, packSize, weather, statHistory);
     }
-    static void displayNodeGUI(const Node* node, int& selectedChoice) {
+    static void displayNodeGUI(const Node& node, int& selectedChoice) {
         UIManager::displayNodeGUI(node, selectedChoice);
     }
     static void showInventoryGUI(Inventory* inventory, Stats& stats) {
         UIManager::showInventoryGUI(inventory, stats);
     }
-    static void displayEventGUI(const std::string& text) {
+    static void displayEventGUI(std::string_view text) {
         UIManager::displayEventGUI(text);
     }
     static void displayEventLog(const std::vector<Event>& events) {
@@ -63,7 +69,7 @@ public:
     static bool displayWelcomeScreen(bool& startGame) {
         return UIManager::displayWelcomeScreen(startGame);
     }
-    static void displayEndingGUI(const std::string& text) {
+    static void displayEndingGUI(std::string_view text) {
         UIManager::displayEndingGUI(text);
     }
 };
\ No newline at end of file
@@ -3,89 +3,66 @@
 #include "ActionQueue.h"
 
 // StatChangeCommand Implementation
-StatChangeCommand::StatChangeCommand(Stats* stats, const StatEffect& effect, const std::string& desc)
-    : targetStats(stats), appliedEffect(effect), reverseEffect(effect.reverse()), description(desc) {}
+StatChangeCommand::StatChangeCommand()
+    : targetStats(nullptr), nodeId(0), choiceIndex(-1) {}
+
+StatChangeCommand::StatChangeCommand(Stats* stats, const StatEffect& effect, int nodeId, int choiceIndex)
+    : targetStats(stats), effect(effect), nodeId(nodeId), choiceIndex(choiceIndex) {}
 
 void StatChangeCommand::execute() {
     if (targetStats) {
-        targetStats->applyEffect(appliedEffect);
+        StatEffect before = targetStats->getValues();
+        targetStats->applyEffect(effect);
+        appliedDelta = targetStats->getValues() - before;
     }
 }
 
+// Reverse the recorded change, not the effect: a clamped stat moved
+// less than the effect asked for
 void StatChangeCommand::undo() {
     if (targetStats) {
-        targetStats->applyEffect(reverseEffect);
+        targetStats->applyEffect(-appliedDelta);
     }
 }
 
+// Built only when asked for, so executing a command never formats text
 std::string StatChangeCommand::getDescription() const {
-    return description;
+    return "Node " + std::to_string(nodeId) + ", choice " + std::to_string(choiceIndex + 1);
 }
 
-// ActionNode Implementation
-ActionNode::ActionNode(Command* cmd, const std::string& name, const std::string& desc)
-    : command(cmd), actionName(name), description(desc), next(nullptr) {}
+int StatChangeCommand::getNodeId() const {
+    return nodeId;
+}
 
-ActionNode::~ActionNode() {
-    delete command;
+int StatChangeCommand::getChoiceIndex() const {
+    return choiceIndex;
 }
 
 // ActionQueue Implementation
-ActionQueue::ActionQueue() : head(nullptr), tail(nullptr), size(0) {}
-
-ActionQueue::~ActionQueue() {
-    clear();
-}
+ActionQueue::ActionQueue() : head(0), size(0) {}
 
-void ActionQueue::enqueue(Command* command, const std::string& actionName, const std::string& description) {
-    if (size >= MAX_BUFFER_SIZE) {
-        removeOldest();
-    }
-    
-    ActionNode* newNode = new ActionNode(command, actionName, description);
-    
-    if (isEmpty()) {
-        head = tail = newNode;
-        newNode->next = newNode; // Circular
-    } else {
-        newNode->next = head;
-        tail->next = newNode;
-        tail = newNode;
+void ActionQueue::executeAndTrack(const StatChangeCommand& command, const char* actionName) {
+    if (size == MAX_BUFFER_SIZE) {
+        head = (head + 1) % MAX_BUFFER_SIZE;
+        size--;
     }
-    size++;
-}
 
-bool ActionQueue::executeAndTrack(Command* command, const std::string& actionName, const std::string& description) {
-    if (!command) return false;
-    
-    command->execute();
-    enqueue(command, actionName, description);
-    return true;
+    ActionNode& slot = slots[(head + size) % MAX_BUFFER_SIZE];
+    slot.command = command;
+    slot.actionName = actionName ? actionName : "";
+    slot.command.execute();
+    size++;
 }
 
 bool ActionQueue::undoLast(std::string& outName, std::string& outDescription) {
     if (isEmpty()) return false;
     
-    outName = tail->actionName;
-    outDescription = tail->description;
-    
-    tail->command->undo();
-    
-    if (size == 1) {
-        delete head;
-        head = tail = nullptr;
-        size = 0;
-    } else {
-        ActionNode* current = head;
-        while (current->next != tail) {
-            current = current->next;
-        }
-        delete tail;
-        tail = current;
-        tail->next = head;
-        size--;
-    }
+    ActionNode& last = slots[(head + size - 1) % MAX_BUFFER_SIZE];
+    outName = last.actionName;
+    outDescription = last.command.getDescription();
     
+    last.command.undo();
+    size--;
     return true;
 }
 
@@ -102,29 +79,11 @@ int ActionQueue::getSize() const {
 }
 
 void ActionQueue::clear() {
-    while (!isEmpty()) {
-        std::string dummy1, dummy2;
-        undoLast(dummy1, dummy2);
-    }
+    head = 0;
+    size = 0;
 }
 
 std::string ActionQueue::peek() const {
     if (isEmpty()) return "";
-    return tail->actionName;
+    return slots[(head + size - 1) % MAX_BUFFER_SIZE].actionName;
 }
-
-void ActionQueue::removeOldest() {
-    if (isEmpty()) return;
-    
-    if (size == 1) {
-        delete head;
-        head = tail = nullptr;
-        size = 0;
-    } else {
-        ActionNode* oldHead = head;
-        head = head->next;
-        tail->next = head;
-        delete oldHead;
-        size--;
-    }
-}
\ No newline at end of file
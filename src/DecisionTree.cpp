@@ -1,27 +1,28 @@
 #include "DecisionTree.h"
-#include <fstream>
 #include <iostream>
 
 // ============================================================
 // CHANGES: Updated to use Choice struct with StatEffects as described in Listing 4.1
 // Implemented navigateToNode as described in Algorithm 1
 // Choices now carry stat effect payloads as described in Ch 2.4
+// Nodes live in a flat NodeStore; navigation works on dense indices
 // ============================================================
 
-DecisionTree::DecisionTree() : currentNodeId(1) {}
+DecisionTree::DecisionTree()
+    : currentNodeId(START_NODE_ID), currentIndex(StoryFormat::NO_INDEX), mappedImage(nullptr) {}
 
-DecisionTree::~DecisionTree() {
-    for (auto& pair : nodes) delete pair.second;
-}
+DecisionTree::~DecisionTree() {}
 
 // Algorithm 1: NavigateToNode implementation
 bool DecisionTree::navigateToNode(int targetID) {
-    if (nodes.find(targetID) == nodes.end()) {
+    uint32_t index = checkedIndex(store.findIndex(targetID));
+    if (index == StoryFormat::NO_INDEX) {
         std::cerr << "Error: Node " << targetID << " not found" << std::endl;
         return false;
     }
     
     currentNodeId = targetID;
+    currentIndex = index;
     // Trigger NodeEnterEvent (simplified - can be expanded)
     std::cout << "Navigated to Node " << targetID << std::endl;
     return true;
@@ -148,76 +149,177 @@ void DecisionTree::loadNodes() {
     createNode(25, "You approach the victorious wolf with respect. They size you up, impressed by your courage in approaching. 'You have guts. I respect that. These lands are harsh, but together we're stronger.' You join forces, combining hunting grounds and watching each other's backs. It's not a traditional pack, but it's a partnership that works. You've found your place.", true);
     setNodeEndingType(25, "Allied Hunters - Partnership for survival");
     addTrigger(25, 25);
+
+    finalize();
+}
+
+// ---------------- Compiled Story Images ----------------
+
+bool DecisionTree::loadFromImage(const std::string& filename) {
+    store.clear();
+    mappedImage = nullptr;
+    if (!image.open(filename)) return false;
+
+    store.bind(image);
+    mappedImage = &image;
+    reset();
+    return true;
+}
+
+bool DecisionTree::isImageLoaded() const {
+    return image.isOpen();
+}
+
+void DecisionTree::attachStory(const DecisionTree& source) {
+    store.clear();
+    image.close();
+    store.bind(source.store);
+    mappedImage = source.mappedImage;
+    reset();
+}
+
+bool DecisionTree::compileImage(const std::string& filename) const {
+    return store.writeImage(filename);
+}
+
+// open() only checks the image's header, so a mapped node's record is
+// checked whenever it is looked up or entered. That costs one pass over
+// its choices, which the caller is about to read anyway, and keeps
+// loading independent of the story size.
+uint32_t DecisionTree::checkedIndex(uint32_t index) const {
+    if (index == StoryFormat::NO_INDEX || !mappedImage || mappedImage->checkNode(index)) return index;
+    std::cerr << "Error: story image node " << index << " is corrupt" << std::endl;
+    return StoryFormat::NO_INDEX;
 }
 
 // --- Remaining DecisionTree member functions ---
 
-const Node* DecisionTree::getCurrentNode() const {
-    auto it = nodes.find(currentNodeId);
-    return it != nodes.end() ? it->second : nullptr;
+Node DecisionTree::getCurrentNode() const {
+    if (currentIndex == StoryFormat::NO_INDEX) return Node();
+    return Node(&store, currentIndex);
+}
+
+int DecisionTree::getCurrentNodeId() const {
+    return currentNodeId;
+}
+
+Node DecisionTree::getNode(int id) const {
+    uint32_t index = checkedIndex(store.findIndex(id));
+    return index != StoryFormat::NO_INDEX ? Node(&store, index) : Node();
+}
+
+Node DecisionTree::getNodeAt(uint32_t index) const {
+    if (index >= store.getNodeCount() || checkedIndex(index) == StoryFormat::NO_INDEX) return Node();
+    return Node(&store, index);
+}
+
+uint32_t DecisionTree::getNodeCount() const {
+    return store.getNodeCount();
+}
+
+const NodeStore& DecisionTree::getStore() const {
+    return store;
 }
 
 bool DecisionTree::makeChoice(int choiceIndex) {
-    const Node* current = getCurrentNode();
-    if (!current) return false;
+    if (currentIndex == StoryFormat::NO_INDEX) return false;
     
-    const auto& choices = current->getChoicesWithEffects();
-    if (choiceIndex < 0 || choiceIndex >= static_cast<int>(choices.size())) return false;
+    const StoryFormat::NodeRecord& current = store.getNode(currentIndex);
+    if (choiceIndex < 0 || choiceIndex >= static_cast<int>(current.choiceCount)) return false;
     
-    currentNodeId = choices[choiceIndex].targetNodeId;
+    // Targets were resolved (and dangling choices dropped) at finalize
+    const StoryFormat::ChoiceRecord& choice = store.getChoice(current.firstChoice + choiceIndex);
+    const uint32_t target = checkedIndex(choice.targetIndex);
+    if (target == StoryFormat::NO_INDEX) return false;
+    currentNodeId = choice.targetNodeId;
+    currentIndex = target;
     return true;
 }
 
 void DecisionTree::reset() { 
-    currentNodeId = 1; 
+    setCurrentNode(START_NODE_ID);
 }
 
 void DecisionTree::setCurrentNode(int nodeId) { 
     currentNodeId = nodeId; 
+    currentIndex = checkedIndex(store.findIndex(nodeId));
 }
 
 void DecisionTree::createNode(int id, const std::string& text, bool isEnding) { 
-    nodes[id] = new Node(id, text, isEnding); 
+    // Building nodes in code replaces any mapped image
+    if (image.isOpen()) {
+        store.clear();
+        image.close();
+    }
+    mappedImage = nullptr;
+    store.addNode(id, text, isEnding);
+    currentIndex = StoryFormat::NO_INDEX;
 }
 
 void DecisionTree::addChoice(int nodeId, const std::string& text, int nextNodeId, const std::vector<StatEffect>& effects) {
-    auto it = nodes.find(nodeId);
-    if (it != nodes.end()) it->second->addChoice(text, nextNodeId, effects);
+    store.addChoice(nodeId, text, nextNodeId, effects);
+    currentIndex = StoryFormat::NO_INDEX;
 }
 
 void DecisionTree::addTrigger(int nodeId, int eventId) {
-    auto it = nodes.find(nodeId);
-    if (it != nodes.end()) it->second->addTrigger(eventId);
+    store.addTrigger(nodeId, eventId);
+    currentIndex = StoryFormat::NO_INDEX;
 }
 
 void DecisionTree::setNodeEndingType(int nodeId, const std::string& type) {
-    auto it = nodes.find(nodeId);
-    if (it != nodes.end()) it->second->setEndingType(type);
+    store.setEndingType(nodeId, type);
+    currentIndex = StoryFormat::NO_INDEX;
 }
 
-void DecisionTree::generateDotFile(const std::string& filename) const {
-    std::ofstream file(filename);
-    if (!file.is_open()) return;
+void DecisionTree::removeNode(int nodeId) {
+    store.removeNode(nodeId);
+    currentIndex = StoryFormat::NO_INDEX;
+}
 
-    file << "digraph DecisionTree {\n  rankdir=TB;\n  node [shape=box, style=rounded];\n\n";
+void DecisionTree::editStory() {
+    store.edit();
+    image.close();
+    mappedImage = nullptr;
+    currentIndex = StoryFormat::NO_INDEX;
+}
 
-    for (const auto& pair : nodes) {
-        const Node* node = pair.second;
-        std::string shape = node->isEndingNode() ? "doubleoctagon" : "box";
-        std::string color = node->isEndingNode() ? ", color=red, style=filled, fillcolor=lightpink" : "";
-        file << "  node" << node->getId() << " [label=\"Node " << node->getId() << "\", shape=" << shape << color << "];\n";
+// Packs the tables and resolves the current position to an index
+void DecisionTree::finalize() {
+    store.finalize();
+    currentIndex = store.findIndex(currentNodeId);
+
+    StoryDiagnostics diagnostics = validate();
+    if (diagnostics.startIndex == StoryFormat::NO_INDEX) {
+        std::cerr << "Error: start node " << START_NODE_ID << " not found" << std::endl;
+    }
+    for (const DanglingChoice& d : diagnostics.danglingChoices) {
+        std::cerr << "Error: Node " << store.getNode(d.owner).id << " choice " << d.slot + 1
+                  << " leads to missing node " << d.record.targetNodeId << std::endl;
     }
+    for (int id : diagnostics.unknownNodeRefs) {
+        std::cerr << "Error: Node " << id << " not found (choice, trigger or ending ignored)" << std::endl;
+    }
+    for (uint32_t n : diagnostics.sinks) {
+        std::cerr << "Error: Node " << store.getNode(n).id << " has no choices and is not an ending" << std::endl;
+    }
+}
 
-    file << "\n";
+StoryDiagnostics DecisionTree::validate() const {
+    return StoryValidator::validate(store, START_NODE_ID);
+}
 
-    for (const auto& pair : nodes) {
-        const Node* node = pair.second;
-        auto choices = node->getChoices();
-        for (size_t i = 0; i < choices.size(); ++i) {
-            file << "  node" << node->getId() << " -> node" << choices[i].second << " [label=\"" << static_cast<char>('A' + i) << "\"];\n";
-        }
-    }
+void DecisionTree::generateDotFile(const std::string& filename) const {
+    exportGraph(filename, GraphFormat::Dot);
+}
 
-    file << "}\n";
-    file.close();
-}
\ No newline at end of file
+bool DecisionTree::exportGraph(const std::string& filename, GraphFormat format) const {
+    return GraphExporter::write(store, filename, format);
+}
+
+bool DecisionTree::exportNeighborhood(const std::string& filename, GraphFormat format, int hops,
+                                      size_t* nodeCount) const {
+    if (currentIndex == StoryFormat::NO_INDEX) return false;
+    std::vector<uint32_t> nodes = GraphExporter::neighborhood(store, currentIndex, hops);
+    if (nodeCount) *nodeCount = nodes.size();
+    return GraphExporter::writeSubgraph(store, nodes, filename, format);
+}
@@ -1,37 +1,5 @@
 #include "Event.h"
-
-// ============================================================
-// StatEffect Implementation
-// ============================================================
-
-StatEffect::StatEffect(
-    int h,
-    int hu,
-    int st,
-    int p,
-    int m,
-    int str,
-    int xp
-)
-    : healthChange(h),
-      hungerChange(hu),
-      staminaChange(st),
-      packStatusChange(p),
-      moraleChange(m),
-      strengthChange(str),
-      xpGain(xp) {}
-
-StatEffect StatEffect::reverse() const {
-    return StatEffect(
-        -healthChange,
-        -hungerChange,
-        -staminaChange,
-        -packStatusChange,
-        -moraleChange,
-        -strengthChange,
-        -xpGain
-    );
-}
+#include <utility>
 
 // ============================================================
 // Event Implementation
@@ -53,7 +21,7 @@ int Event::getId() const {
     return id;
 }
 
-std::string Event::getDescription() const {
+std::string_view Event::getDescription() const {
     return description;
 }
 
@@ -72,8 +40,16 @@ void Event::execute() {
     }
 }
 
-void Event::setAction(std::function<void()> act) {
-    action = act;
+void Event::setAction(EventAction act) {
+    action = std::move(act);
+}
+
+void Event::reset(int newId, std::string_view newDescription, Priority newPriority, const StatEffect& newEffect) {
+    id = newId;
+    description.assign(newDescription.data(), newDescription.size());
+    priority = newPriority;
+    effect = newEffect;
+    action = nullptr;
 }
 
 // Higher priority comes first in priority_queue
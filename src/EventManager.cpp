@@ -1,14 +1,54 @@
 #include "EventManager.h"
-#include <iostream>
+#include "EventTrace.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <utility>
 
 // ============================================================
 // CHANGES: Implemented Algorithm 2 (Priority Event Dispatcher)
 // Added update() method with threshold and notification
 // Added pushEvent() as described in Listing 5.1
+// Event actions are inline, move-only callables (InlineFunction.h)
 // Added pollStats() for automatic stat-based event triggering (Ch 5.2)
+// Queue is bucketed per Priority (EventQueue.h): O(1), FIFO within a level
+// Queue carries 8-byte EventHandles; events are resolved in place
+// Registry is a dense slot array behind an ID remap table, frozen after load
+// update() drains every pending event per tick within a DispatchBudget
+// pollStats() evaluates an edge-triggered rule table (StatRules.h)
+// Delayed and recurring events run on timer wheels (TimerWheel.h)
+// Other threads post through a lock-free ingestion queue (MpscQueue.h)
+// Duplicate triggers coalesce into the pending occurrence (PendingTable.h)
+// Queued, dispatched and dropped events are recorded to the trace (EventTrace.h)
+// Events can add timed modifiers to the player (ModifierPool.h)
 // ============================================================
 
-EventManager::EventManager() = default;
+namespace {
+    // Key of a pushed event: FNV-1a over priority and message, with the
+    // top bit set so it never collides with a registry key (slot + 1)
+    uint64_t messageKey(Priority p, std::string_view msg) {
+        uint64_t hash = 0xCBF29CE484222325ull ^ static_cast<uint64_t>(p);
+        hash *= 0x100000001B3ull;
+        for (char c : msg) {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 0x100000001B3ull;
+        }
+        return hash | (1ull << 63);
+    }
+}
+
+EventManager::EventManager()
+    : frozen(false),
+      coalescing(true),
+      coalesceWindow(0),
+      tickCount(0),
+      coalescedSinceTick(0),
+      minimumPriority(Priority::LOW),
+      realTimeCarry(0.0),
+      ingress(INGRESS_CAPACITY),
+      ingressPosted(0),
+      ingressDropped(0),
+      ingressDrained(0) {}
 
 // ---------------- Registration ----------------
 
@@ -16,96 +56,509 @@ bool EventManager::registerEvent(int id,
                                  const std::string& description,
                                  Priority priority,
                                  const StatEffect& effect) {
+    if (frozen || id < 0 || id > MAX_EVENT_ID)
+        return false;
+
     // Prevent duplicate IDs
-    if (eventRegistry.find(id) != eventRegistry.end())
+    if (static_cast<size_t>(id) >= slotById.size())
+        slotById.resize(static_cast<size_t>(id) + 1, EventHandle::NONE);
+    else if (slotById[id] != EventHandle::NONE)
         return false;
 
-    eventRegistry.emplace(id, Event(id, description, priority, effect));
+    slotById[id] = static_cast<uint32_t>(registeredEvents.size());
+    registeredEvents.emplace_back(id, description, priority, effect);
+    hasFollowUp.push_back(0);
+    hasModifier.push_back(0);
     return true;
 }
 
+void EventManager::reserve(size_t count, int maxId) {
+    registeredEvents.reserve(registeredEvents.size() + count);
+    hasFollowUp.reserve(hasFollowUp.size() + count);
+    hasModifier.reserve(hasModifier.size() + count);
+    if (maxId >= 0 && maxId <= MAX_EVENT_ID && static_cast<size_t>(maxId) >= slotById.size())
+        slotById.resize(static_cast<size_t>(maxId) + 1, EventHandle::NONE);
+}
+
+void EventManager::freeze() {
+    frozen = true;
+    registeredEvents.shrink_to_fit();
+    slotById.shrink_to_fit();
+    prepareRules();
+}
+
+bool EventManager::isFrozen() const {
+    return frozen;
+}
+
+size_t EventManager::getRegisteredCount() const {
+    return registeredEvents.size();
+}
+
+const Event* EventManager::findEvent(int id) const {
+    if (id < 0 || static_cast<size_t>(id) >= slotById.size()) return nullptr;
+    uint32_t slot = slotById[id];
+    return slot == EventHandle::NONE ? nullptr : &registeredEvents[slot];
+}
+
 // ---------------- Triggering ----------------
 
 bool EventManager::triggerEvent(int eventId) {
-    auto it = eventRegistry.find(eventId);
-    if (it == eventRegistry.end())
+    if (eventId < 0 || static_cast<size_t>(eventId) >= slotById.size())
+        return false;
+
+    EventHandle handle;
+    handle.slot = slotById[eventId];
+    if (handle.slot == EventHandle::NONE)
         return false;
 
-    eventQueue.push(it->second);
+    const Event& e = registeredEvents[handle.slot];
+    WOLF_TRACE(EventTrace::RecordKind::Queued, eventId, e.getPriority(), 1, StatEffect());
+    if (hasFollowUp[handle.slot]) scheduleFollowUps(eventId);
+    if (hasModifier[handle.slot]) applyModifiers(eventId);
+    if (coalescing && mergePending(handle.slot + 1)) return true;
+    eventQueue.push(e.getPriority(), handle);
     return true;
 }
 
-void EventManager::pushEvent(Priority p, const std::string& msg, std::function<void()> action) {
-    // Create event with priority and action
-    Event evt(0, msg, p, StatEffect());
-    evt.setAction(action);
-    eventQueue.push(evt);
+const Event* EventManager::dispatchNow(int eventId) {
+    const Event* evt = findEvent(eventId);
+    if (!evt) return nullptr;
+    WOLF_TRACE(EventTrace::RecordKind::Immediate, eventId, evt->getPriority(), 1, evt->getEffect());
+    if (hasFollowUp[slotById[eventId]]) scheduleFollowUps(eventId);
+    if (hasModifier[slotById[eventId]]) applyModifiers(eventId);
+    return evt;
+}
+
+void EventManager::pushEvent(Priority p, std::string_view msg, EventAction action) {
+    WOLF_TRACE(EventTrace::RecordKind::Queued, -1, p, 1, StatEffect());
+
+    // A duplicate only bumps the pending count; its action is discarded
+    const uint64_t key = coalescing ? messageKey(p, msg) : 0;
+    if (coalescing && mergePending(key)) return;
+
+    // Create event with priority and action in a free arena slot; a
+    // recycled slot keeps its description buffer, so nothing is allocated
+    EventHandle handle;
+    if (!freeInstances.empty()) {
+        handle.instance = freeInstances.back();
+        freeInstances.pop_back();
+        instances[handle.instance].reset(0, msg, p, StatEffect());
+    } else {
+        handle.instance = static_cast<uint32_t>(instances.size());
+        instances.emplace_back(0, std::string(msg), p, StatEffect());
+    }
+    instances[handle.instance].setAction(std::move(action));
+    if (instanceKeys.size() < instances.size()) instanceKeys.resize(instances.size());
+    instanceKeys[handle.instance] = key;
+    eventQueue.push(p, handle);
+}
+
+// ---------------- Coalescing ----------------
+
+// True if 'key' joined an occurrence already pending; otherwise the
+// caller queues a new one
+bool EventManager::mergePending(uint64_t key) {
+    PendingTable::Entry* entry = pending.find(key);
+    if (entry) {
+        ++entry->count;
+        ++coalescedSinceTick;
+        return true;
+    }
+    pending.insert(key, tickCount + coalesceWindow);
+    return false;
+}
+
+uint64_t EventManager::keyOf(EventHandle handle) const {
+    return handle.isRegistered() ? static_cast<uint64_t>(handle.slot) + 1 : instanceKeys[handle.instance];
+}
+
+void EventManager::setCoalescing(bool enabled, uint32_t windowTicks) {
+    coalescing = enabled;
+    coalesceWindow = windowTicks;
+    if (!enabled) {
+        // Held-back occurrences become ordinary queued events
+        pending.clear();
+        for (EventHandle handle : deferred) eventQueue.push(resolve(handle).getPriority(), handle);
+        deferred.clear();
+    }
+}
+
+// ---------------- Cross-thread Posting ----------------
+
+bool EventManager::postEvent(int eventId) {
+    PostedEvent posted;
+    posted.eventId = eventId;
+    if (!ingress.push(posted)) {
+        ingressDropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    ingressPosted.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool EventManager::postEvent(Priority p, std::string_view msg) {
+    PostedEvent posted;
+    posted.priority = p;
+    size_t length = msg.size() < PostedEvent::TEXT_SIZE - 1 ? msg.size() : PostedEvent::TEXT_SIZE - 1;
+    std::memcpy(posted.text, msg.data(), length);
+    posted.text[length] = '\0';
+    if (!ingress.push(posted)) {
+        ingressDropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    ingressPosted.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+IngressStats EventManager::getIngressStats() const {
+    IngressStats stats;
+    stats.posted = ingressPosted.load(std::memory_order_relaxed);
+    stats.dropped = ingressDropped.load(std::memory_order_relaxed);
+    stats.drained = ingressDrained;
+    return stats;
+}
+
+// Frame thread only
+void EventManager::drainIngress() {
+    PostedEvent posted;
+    for (size_t i = 0; i < ingress.capacity() && ingress.pop(posted); ++i) {
+        if (posted.eventId >= 0) triggerEvent(posted.eventId);
+        else pushEvent(posted.priority, posted.text);
+        ++ingressDrained;
+    }
 }
 
 // ---------------- Queue Management ----------------
 
 bool EventManager::hasEvents() const {
-    return !eventQueue.empty();
+    return !eventQueue.empty() || !deferred.empty();
 }
 
-Event EventManager::getNextEvent() {
-    Event evt = eventQueue.top();
-    eventQueue.pop();
-    return evt;
+size_t EventManager::getQueuedCount() const {
+    return eventQueue.size() + deferred.size();
+}
+
+EventHandle EventManager::popEvent(int* repeatCount) {
+    if (eventQueue.empty()) {
+        for (EventHandle handle : deferred) eventQueue.push(resolve(handle).getPriority(), handle);
+        deferred.clear();
+    }
+
+    EventHandle handle = eventQueue.pop();
+    int count = 1;
+    const uint64_t key = coalescing ? keyOf(handle) : 0;
+    if (key != 0) {
+        PendingTable::Entry* entry = pending.find(key);
+        if (entry) {
+            count = static_cast<int>(entry->count);
+            pending.erase(entry);
+        }
+    }
+    if (repeatCount) *repeatCount = count;
+    return handle;
+}
+
+Event& EventManager::resolve(EventHandle handle) {
+    return handle.isRegistered() ? registeredEvents[handle.slot] : instances[handle.instance];
+}
+
+void EventManager::release(EventHandle handle) {
+    if (handle.isRegistered()) return;
+    instances[handle.instance].setAction(nullptr);
+    freeInstances.push_back(handle.instance);
 }
 
 // Algorithm 2: Priority Event Dispatcher implementation
-void EventManager::update(Stats* stats, std::function<void(const std::string&)> notifyUI) {
-    if (!hasEvents()) return;
-    
-    Event e = getNextEvent();
-    
-    // Check threshold for critical events (Algorithm 2)
-    if (static_cast<int>(e.getPriority()) >= static_cast<int>(Priority::HIGH)) {
-        // Execute effect
+DispatchStats EventManager::update(Stats* stats, const std::function<void(std::string_view)>& notifyUI) {
+    using Clock = std::chrono::steady_clock;
+    const int CLOCK_INTERVAL = 16;   // events between deadline checks
+
+    drainIngress();
+
+    // Occurrences held back by the coalescing window get another look
+    for (EventHandle handle : deferred) eventQueue.push(resolve(handle).getPriority(), handle);
+    deferred.clear();
+
+    DispatchStats tick;
+    tick.queuedBefore = eventQueue.size();
+    tick.coalesced = coalescedSinceTick;
+    coalescedSinceTick = 0;
+
+    const bool timed = budget.maxMicroseconds > 0;
+    const Clock::time_point deadline = timed
+        ? Clock::now() + std::chrono::microseconds(budget.maxMicroseconds)
+        : Clock::time_point();
+
+    size_t processed = 0;
+    while (!eventQueue.empty()) {
+        if (budget.maxEvents != 0 && processed >= budget.maxEvents) break;
+        if (timed && processed % CLOCK_INTERVAL == 0 && processed != 0 && Clock::now() >= deadline) break;
+
+        EventHandle handle = eventQueue.pop();
+        int repeats = 1;
+        const uint64_t key = coalescing ? keyOf(handle) : 0;
+        if (key != 0) {
+            PendingTable::Entry* entry = pending.find(key);
+            if (entry) {
+                // Still inside its window: keep collecting duplicates
+                if (entry->readyTick > tickCount) {
+                    deferred.push_back(handle);
+                    continue;
+                }
+                repeats = static_cast<int>(entry->count);
+                pending.erase(entry);
+            }
+        }
+        ++processed;
+
+        Event& e = resolve(handle);
+        const int traceId = handle.isRegistered() ? e.getId() : -1;
+
+        if (static_cast<int>(e.getPriority()) < static_cast<int>(minimumPriority)) {
+            WOLF_TRACE(EventTrace::RecordKind::Dropped, traceId, e.getPriority(), repeats, StatEffect());
+            ++tick.dropped;
+            release(handle);
+            continue;
+        }
+
+        // Execute effect, once per merged trigger
         e.execute();
+        const StatEffect effect = repeats == 1 ? e.getEffect() : e.getEffect() * repeats;
         if (stats) {
-            stats->applyEffect(e.getEffect());
+            stats->applyEffect(effect);
         }
-        
-        // Notify UI
-        if (notifyUI) {
+        WOLF_TRACE(EventTrace::RecordKind::Dispatched, traceId, e.getPriority(), repeats, effect);
+
+        // Class handler, or notify UI
+        const EventHandler& handler = handlers[static_cast<int>(e.getPriority()) - 1];
+        if (handler) {
+            handler(e, repeats);
+        } else if (notifyUI) {
             notifyUI(e.getDescription());
         }
+
+        ++tick.drained;
+        release(handle);
+    }
+
+    tick.remaining = eventQueue.size() + deferred.size();
+    ++tickCount;
+    lastTick = tick;
+    return tick;
+}
+
+void EventManager::setBudget(const DispatchBudget& b) {
+    budget = b;
+}
+
+void EventManager::setHandler(Priority priority, EventHandler handler) {
+    handlers[static_cast<int>(priority) - 1] = std::move(handler);
+}
+
+void EventManager::setMinimumPriority(Priority priority) {
+    minimumPriority = priority;
+}
+
+const DispatchStats& EventManager::getLastTick() const {
+    return lastTick;
+}
+
+// ---------------- Stat Rules ----------------
+
+bool EventManager::addRule(const StatRule& rule) {
+    if (frozen) return false;
+    statRules.add(rule);
+    return true;
+}
+
+const StatRuleSet& EventManager::getRules() const {
+    return statRules;
+}
+
+void EventManager::prepareRules() {
+    statRules.compile();
+    ruleArmed.assign(statRules.size(), 1);
+    ruleFired.assign(statRules.size(), 0);
+}
+
+// A single entity: one value per column
+void EventManager::columnsOf(const Stats* stats, int* values, StatColumns& columns) {
+    for (int i = 0; i < STAT_COUNT; ++i) {
+        values[i] = stats->getStat(static_cast<StatId>(i));
+        columns.values[i] = &values[i];
     }
+    columns.count = 1;
 }
 
 // Stat polling mechanism (Ch 5.2) - automatically triggers events based on stat values
 void EventManager::pollStats(Stats* stats) {
     if (!stats) return;
-    
-    // Check for critical stat conditions
-    if (stats->getHealth() < CRITICAL_THRESHOLD) {
-        pushEvent(Priority::CRITICAL, "Your health is critically low!", [stats]() {
-            std::cout << "CRITICAL: Low health detected!" << std::endl;
-        });
+    if (ruleArmed.size() != statRules.size()) prepareRules();
+
+    int values[STAT_COUNT];
+    StatColumns columns;
+    columnsOf(stats, values, columns);
+
+    if (statRules.evaluate(columns, ruleArmed.data(), ruleFired.data()) == 0) return;
+    for (size_t r = 0; r < ruleFired.size(); ++r) {
+        if (ruleFired[r]) triggerEvent(statRules.getEventId(r));
     }
-    
-    if (stats->getHunger() > 80) {
-        pushEvent(Priority::HIGH, "You are starving!", [stats]() {
-            stats->setHealth(stats->getHealth() - 5);
-        });
+}
+
+void EventManager::syncRules(const Stats* stats) {
+    if (!stats) return;
+    if (ruleArmed.size() != statRules.size()) prepareRules();
+
+    int values[STAT_COUNT];
+    StatColumns columns;
+    columnsOf(stats, values, columns);
+    statRules.sync(columns, ruleArmed.data());
+}
+
+// ---------------- Timers ----------------
+
+TimerId EventManager::scheduleEvent(int eventId, TimerDomain domain, uint32_t delay, uint32_t period) {
+    TimerWheel& wheel = domain == TimerDomain::GameDays ? dayTimers : realTimers;
+    return wheel.schedule(delay, period, eventId);
+}
+
+bool EventManager::cancelTimer(TimerDomain domain, TimerId id) {
+    TimerWheel& wheel = domain == TimerDomain::GameDays ? dayTimers : realTimers;
+    return wheel.cancel(id);
+}
+
+size_t EventManager::getPendingTimers() const {
+    return dayTimers.size() + realTimers.size();
+}
+
+bool EventManager::addFollowUp(int eventId, int followUpId, uint32_t delayDays, uint32_t periodDays) {
+    if (frozen || !findEvent(eventId)) return false;
+    followUps.push_back({eventId, followUpId, delayDays, periodDays});
+    hasFollowUp[slotById[eventId]] = 1;
+    return true;
+}
+
+const std::vector<EventManager::FollowUp>& EventManager::getFollowUps() const {
+    return followUps;
+}
+
+void EventManager::scheduleFollowUps(int eventId) {
+    for (const FollowUp& f : followUps) {
+        if (f.eventId == eventId) scheduleEvent(f.followUpId, TimerDomain::GameDays, f.delayDays, f.periodDays);
     }
-    
-    if (stats->getStamina() < CRITICAL_THRESHOLD) {
-        pushEvent(Priority::MEDIUM, "Exhaustion overwhelms you.", [stats]() {
-            std::cout << "WARNING: Low stamina!" << std::endl;
-        });
+}
+
+void EventManager::setDay(int day) {
+    if (day < 0) return;
+    dayTimers.advance(static_cast<uint64_t>(day), expiredEvents);
+    queueExpired();
+}
+
+void EventManager::advanceRealTime(double seconds) {
+    if (seconds <= 0.0) return;
+    realTimeCarry += seconds * 1000.0;
+    uint64_t ticks = static_cast<uint64_t>(realTimeCarry);
+    if (ticks == 0) return;
+    realTimeCarry -= static_cast<double>(ticks);
+    realTimers.advance(realTimers.getTime() + ticks, expiredEvents);
+    queueExpired();
+}
+
+void EventManager::queueExpired() {
+    for (int eventId : expiredEvents) triggerEvent(eventId);
+    expiredEvents.clear();
+}
+
+void EventManager::clear() {
+    eventQueue.clear();
+    deferred.clear();
+    pending.clear();
+    coalescedSinceTick = 0;
+
+    // Every arena slot becomes free again; buffers are kept
+    freeInstances.clear();
+    for (uint32_t i = 0; i < instances.size(); ++i) {
+        instances[i].setAction(nullptr);
+        freeInstances.push_back(i);
     }
-    
-    if (stats->getMorale() < 10) {
-        pushEvent(Priority::HIGH, "Despair sets in...", [stats]() {
-            std::cout << "WARNING: Morale critical!" << std::endl;
-        });
+    std::fill(ruleArmed.begin(), ruleArmed.end(), 1);
+    dayTimers.clear();
+    realTimers.clear();
+    realTimeCarry = 0.0;
+    modifiers.clear();
+}
+
+// ---------------- Modifiers ----------------
+
+int EventManager::defineModifier(const std::string& name, const ModifierType& type) {
+    if (frozen || name.empty() || findModifier(name) >= 0) return -1;
+    const int kind = modifiers.defineType(type);
+    if (kind >= 0) modifierNames.push_back(name);
+    return kind;
+}
+
+int EventManager::findModifier(std::string_view name) const {
+    for (size_t kind = 0; kind < modifierNames.size(); ++kind) {
+        if (modifierNames[kind] == name) return static_cast<int>(kind);
     }
+    return -1;
 }
 
-void EventManager::clear() {
-    while (!eventQueue.empty())
-        eventQueue.pop();
-}
\ No newline at end of file
+std::string_view EventManager::getModifierName(int kind) const {
+    if (kind < 0 || kind >= static_cast<int>(modifierNames.size())) return std::string_view();
+    return modifierNames[kind];
+}
+
+bool EventManager::addModifier(int eventId, int kind) {
+    if (frozen || !findEvent(eventId) || !modifiers.findType(kind)) return false;
+    modifierLinks.push_back({eventId, kind});
+    hasModifier[slotById[eventId]] = 1;
+    return true;
+}
+
+void EventManager::applyModifiers(int eventId) {
+    for (const ModifierLink& link : modifierLinks) {
+        if (link.eventId == eventId) modifiers.add(0, link.kind);
+    }
+}
+
+ModifierPool& EventManager::getModifiers() {
+    return modifiers;
+}
+
+const ModifierPool& EventManager::getModifiers() const {
+    return modifiers;
+}
+
+// ---------------- Saved Positions ----------------
+
+void EventManager::saveSchedule(DaySchedule& out) const {
+    out.timers.clear();
+    dayTimers.getPending(pendingTimers);
+    for (const TimerWheel::Pending& timer : pendingTimers) {
+        out.timers.push_back({ timer.eventId, static_cast<int>(timer.expires),
+                               static_cast<uint32_t>(timer.period) });
+    }
+    std::sort(out.timers.begin(), out.timers.end());
+    modifiers.save(out.modifiers, static_cast<int>(dayTimers.getTime()));
+
+    // Rules not yet evaluated are all armed
+    if (ruleArmed.size() == statRules.size()) out.ruleArmed = ruleArmed;
+    else out.ruleArmed.assign(statRules.size(), 1);
+}
+
+void EventManager::restoreSchedule(int day, const DaySchedule& schedule) {
+    if (day < 0) return;
+    dayTimers.clear(static_cast<uint64_t>(day));
+    for (const DayTimer& timer : schedule.timers) {
+        const int delay = timer.dueDay - day;
+        dayTimers.schedule(delay > 0 ? static_cast<uint64_t>(delay) : 1, timer.period, timer.eventId);
+    }
+    modifiers.restore(schedule.modifiers, day);
+
+    if (ruleArmed.size() != statRules.size()) prepareRules();
+    for (size_t r = 0; r < ruleArmed.size(); ++r) {
+        ruleArmed[r] = r < schedule.ruleArmed.size() ? schedule.ruleArmed[r] : 1;
+    }
+}
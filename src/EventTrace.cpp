@@ -0,0 +1,192 @@
+#include "EventTrace.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#define EVENTTRACE_TSC 1
+#endif
+
+// ============================================================
+// EventTrace Implementation
+// ============================================================
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    const uint32_t BUFFER_RECORDS = 1024;   // per thread, 40 KB
+
+    // Writer state shared by all threads; the file is only touched
+    // with the mutex held
+    std::atomic<bool> active(false);
+    std::mutex fileMutex;
+    std::FILE* file = nullptr;
+    bool writeFailed = false;
+    uint64_t openTicks = 0;
+    Clock::time_point openTime;
+    std::atomic<uint16_t> nextThread(0);
+
+    inline uint64_t now() {
+#ifdef EVENTTRACE_TSC
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    inline int16_t saturate(int value) {
+        return static_cast<int16_t>(value < INT16_MIN ? INT16_MIN : value > INT16_MAX ? INT16_MAX : value);
+    }
+
+    struct ThreadBuffer {
+        EventTrace::Record records[BUFFER_RECORDS];
+        uint32_t used = 0;
+        uint16_t thread;
+        int32_t day = 0;
+        int32_t node = 0;
+
+        ThreadBuffer() : thread(nextThread.fetch_add(1, std::memory_order_relaxed)) {}
+        ~ThreadBuffer() { flush(); }
+
+        void flush() {
+            if (used == 0) return;
+            std::lock_guard<std::mutex> lock(fileMutex);
+            if (file && !writeFailed) {
+                writeFailed = std::fwrite(records, sizeof(EventTrace::Record), used, file) != used;
+            }
+            used = 0;
+        }
+    };
+
+    // The buffer itself needs a guarded thread_local (it flushes on thread
+    // exit); the hot path only reads this plain pointer to it
+    thread_local ThreadBuffer* current = nullptr;
+
+    ThreadBuffer& localBuffer() {
+        if (!current) {
+            thread_local ThreadBuffer buffer;
+            current = &buffer;
+        }
+        return *current;
+    }
+
+    bool writeHeader(double ticksPerSecond) {
+        EventTrace::Header header;
+        header.magic = EventTrace::MAGIC;
+        header.version = EventTrace::VERSION;
+        header.recordSize = sizeof(EventTrace::Record);
+        header.reserved = 0;
+        header.ticksPerSecond = ticksPerSecond;
+        return std::fseek(file, 0, SEEK_SET) == 0 && std::fwrite(&header, sizeof(header), 1, file) == 1;
+    }
+}
+
+namespace EventTrace {
+
+// ---------------- Writing ----------------
+
+bool open(const std::string& path, std::string& error) {
+    std::lock_guard<std::mutex> lock(fileMutex);
+    if (file) {
+        error = "a trace is already open";
+        return false;
+    }
+    file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        error = "cannot create " + path;
+        return false;
+    }
+    if (!writeHeader(0.0)) {
+        std::fclose(file);
+        file = nullptr;
+        error = "cannot write " + path;
+        return false;
+    }
+    writeFailed = false;
+    openTicks = now();
+    openTime = Clock::now();
+    active.store(true, std::memory_order_release);
+    return true;
+}
+
+void close() {
+    localBuffer().flush();
+    active.store(false, std::memory_order_release);
+
+    std::lock_guard<std::mutex> lock(fileMutex);
+    if (!file) return;
+
+    // Tick rate over the whole recording
+    double seconds = std::chrono::duration<double>(Clock::now() - openTime).count();
+#ifdef EVENTTRACE_TSC
+    double ticksPerSecond = seconds > 0 ? static_cast<double>(now() - openTicks) / seconds : 0.0;
+#else
+    double ticksPerSecond = 1e9;
+    (void)seconds;
+#endif
+    std::fseek(file, 0, SEEK_END);
+    if (!writeHeader(ticksPerSecond)) writeFailed = true;
+    std::fclose(file);
+    file = nullptr;
+}
+
+bool isOpen() {
+    return active.load(std::memory_order_relaxed);
+}
+
+void setContext(int day, int node) {
+    ThreadBuffer& buffer = localBuffer();
+    buffer.day = day;
+    buffer.node = node;
+}
+
+void record(RecordKind kind, int eventId, Priority priority, int repeat, const StatEffect& effect) {
+    if (!active.load(std::memory_order_relaxed)) return;
+
+    ThreadBuffer& buffer = localBuffer();
+    Record& r = buffer.records[buffer.used];
+    r.timestamp = now();
+    r.eventId = eventId;
+    r.node = buffer.node;
+    r.day = buffer.day;
+    r.kind = static_cast<uint8_t>(kind);
+    r.priority = static_cast<uint8_t>(priority);
+    r.repeat = static_cast<uint16_t>(repeat);
+    for (int s = 0; s < STAT_COUNT; ++s) r.delta[s] = saturate(effect.lanes[s]);
+    r.thread = buffer.thread;
+    if (++buffer.used == BUFFER_RECORDS) buffer.flush();
+}
+
+// ---------------- Reading ----------------
+
+bool load(const std::string& path, Header& header, std::vector<Record>& records, std::string& error) {
+    std::FILE* in = std::fopen(path.c_str(), "rb");
+    if (!in) {
+        error = "cannot open " + path;
+        return false;
+    }
+
+    bool ok = false;
+    if (std::fread(&header, sizeof(header), 1, in) != 1 || header.magic != MAGIC) {
+        error = "not an event trace";
+    } else if (header.version != VERSION || header.recordSize != sizeof(Record)) {
+        error = "unsupported trace version";
+    } else {
+        records.clear();
+        Record r;
+        while (std::fread(&r, sizeof(r), 1, in) == 1) records.push_back(r);
+        ok = !std::ferror(in);
+        if (!ok) error = "read error";
+    }
+    std::fclose(in);
+    return ok;
+}
+
+}
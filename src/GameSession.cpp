@@ -0,0 +1,322 @@
+#include "GameSession.h"
+#include "EventTrace.h"
+#include "StoryParser.h"
+#include <iostream>
+
+// ============================================================
+// Choice-resolution pipeline extracted from gameLoop (main.cpp)
+// so it can run without a window, e.g. in batch simulations
+// ============================================================
+
+GameSession::GameSession(DecisionTree& tree, const SessionOptions& options)
+    : tree(tree),
+      options(options),
+      rng(options.seed != 0 ? options.seed : std::random_device{}()),
+      encounterRoll(1, 100) {
+    state.inventory = new Inventory();
+    registerEvents();
+    tree.reset();
+    state.currentNodeId = tree.getCurrentNodeId();
+    EventTrace::setContext(state.day, state.currentNodeId);
+    events.setDay(state.day);
+    if (options.keepStatHistory) statHistory.days.record(state.stats);
+}
+
+GameSession::~GameSession() {
+    delete state.inventory;
+}
+
+// ---------------- Initialize Events ----------------
+void GameSession::registerEvents() {
+    if (!options.eventsPath.empty()) {
+        std::string error;
+        if (StoryParser::loadEvents(options.eventsPath, events, error)) return;
+        std::cerr << "Error loading " << options.eventsPath << ": " << error
+                  << " (using built-in events)" << std::endl;
+    }
+
+    events.registerEvent(1, "The cold wind bites at your fur. Your body shivers.", Priority::MEDIUM, StatEffect(0, 5, -10, 0));
+    events.registerEvent(2, "The icy air drains your energy as you track the prey.", Priority::MEDIUM, StatEffect(0, 5, -15, 0));
+    events.registerEvent(3, "Your hunger grows as you wait in the snow.", Priority::MEDIUM, StatEffect(0, 10, -5, 0));
+    events.registerEvent(4, "The ice cracks dangerously beneath you!", Priority::HIGH, StatEffect(-20, 0, -20, 0));
+    events.registerEvent(5, "The long detour exhausts you further.", Priority::MEDIUM, StatEffect(0, 10, -15, 0));
+    events.registerEvent(6, "Tension rises as the strange wolves approach.", Priority::MEDIUM, StatEffect(0, 5, -10, 5));
+    events.registerEvent(7, "The encounter leaves you wary and alert.", Priority::MEDIUM, StatEffect(0, 5, -10, 0));
+    events.registerEvent(8, "You feast on fresh venison! Your strength returns.", Priority::HIGH, StatEffect(30, -50, 40, 0));
+    events.registerEvent(9, "Caution preserves your energy.", Priority::LOW, StatEffect(0, 5, 5, 0));
+    events.registerEvent(10, "Ancient knowledge fills you with confidence.", Priority::LOW, StatEffect(10, 0, 0, 10));
+
+    // Random encounters
+    events.registerEvent(100, "You found some winter berries hidden under snow!", Priority::LOW, StatEffect(0, -10, 0, 0));
+    events.registerEvent(101, "A harsh wind chills you to the bone.", Priority::MEDIUM, StatEffect(0, 5, -15, 0));
+
+    // Stat threshold events (Ch 5.2)
+    events.registerEvent(200, "Your health is critically low!", Priority::CRITICAL, StatEffect());
+    events.registerEvent(201, "You are starving!", Priority::HIGH, StatEffect(-5, 0, 0, 0));
+    events.registerEvent(202, "Exhaustion overwhelms you.", Priority::MEDIUM, StatEffect());
+    events.registerEvent(203, "Despair sets in...", Priority::HIGH, StatEffect());
+
+    // Delayed consequences
+    events.registerEvent(204, "The wound from the ice aches and worsens.", Priority::HIGH, StatEffect(-10, 0, -5, 0));
+    events.addFollowUp(4, 204, 3);
+
+    // Timed modifiers, and the events that add them to the player
+    ModifierType wounded;
+    wounded.effect = StatEffect(-3, 0, -2, 0);
+    wounded.duration = 4;
+    wounded.stacking = Stacking::Stack;
+    wounded.maxStacks = 3;
+    wounded.decay = Decay::Linear;
+    ModifierType wellFed;
+    wellFed.effect = StatEffect(2, 0, 5, 0);
+    wellFed.duration = 3;
+    ModifierType exhausted;
+    exhausted.effect = StatEffect(0, 0, 0, 0, -2);
+    exhausted.duration = 3;
+    ModifierType despairing;
+    despairing.effect = StatEffect(0, 0, -3, 0);
+    despairing.duration = 3;
+
+    events.addModifier(4, events.defineModifier("wounded", wounded));
+    events.addModifier(8, events.defineModifier("wellfed", wellFed));
+    events.addModifier(202, events.defineModifier("exhausted", exhausted));
+    events.addModifier(203, events.defineModifier("despairing", despairing));
+
+    // stat, comparator, threshold, hysteresis, event
+    const StatRule rules[] = {
+        { StatId::Health,  Comparator::Below, 20, 5,  200 },
+        { StatId::Hunger,  Comparator::Above, 80, 10, 201 },
+        { StatId::Stamina, Comparator::Below, 20, 5,  202 },
+        { StatId::Morale,  Comparator::Below, 10, 5,  203 },
+    };
+    for (const StatRule& rule : rules) events.addRule(rule);
+
+    events.freeze();
+}
+
+void GameSession::restart() {
+    actions.clear();
+    history.clear();
+    events.clear();
+    statHistory.clear();
+    eventLog.clear();
+
+    Inventory* inventory = state.inventory;
+    inventory->clear();
+    state = GameState();
+    state.inventory = inventory;
+
+    tree.reset();
+    state.currentNodeId = tree.getCurrentNodeId();
+    EventTrace::setContext(state.day, state.currentNodeId);
+    events.setDay(state.day);
+    if (options.keepStatHistory) statHistory.days.record(state.stats);
+}
+
+void GameSession::setListener(Listener l) {
+    listener = l;
+}
+
+void GameSession::notify(SessionMessage message, std::string_view text) {
+    if (listener) listener(message, text);
+}
+
+// ---------------- Random Events ----------------
+namespace {
+    // Upper roll (1..100) of each encounter; rolls above MEAT_ROLL find nothing
+    const int BERRIES_ROLL = 15;
+    const int HERBS_ROLL = 25;
+    const int WIND_ROLL = 35;
+    const int MEAT_ROLL = 40;
+}
+
+void GameSession::generateRandomEvent(int roll) {
+    Inventory* inventory = state.inventory;
+
+    if (roll <= BERRIES_ROLL) {
+        events.triggerEvent(100);
+        inventory->addItem("Winter Berries", "FOOD", 10, 1);
+        notify(SessionMessage::ItemFound, "Found: Winter Berries!");
+    }
+    else if (roll <= HERBS_ROLL && !inventory->isFull()) {
+        inventory->addItem("Healing Herbs", "HERB", 20, 1);
+        notify(SessionMessage::ItemFound, "Found: Healing Herbs!");
+    }
+    else if (roll <= WIND_ROLL) {
+        events.triggerEvent(101);
+        notify(SessionMessage::Hazard, "A harsh wind strikes!");
+    }
+    else if (roll <= MEAT_ROLL && !inventory->isFull()) {
+        inventory->addItem("Dried Meat", "FOOD", 25, 1);
+        notify(SessionMessage::ItemFound, "Found: Dried Meat!");
+    }
+}
+
+const std::vector<int>& GameSession::getEncounterRolls() {
+    static const std::vector<int> rolls = {
+        1, BERRIES_ROLL + 1, HERBS_ROLL + 1, WIND_ROLL + 1, MEAT_ROLL + 1
+    };
+    return rolls;
+}
+
+// ---------------- Choice Resolution ----------------
+bool GameSession::choose(int choiceIndex) {
+    return resolveChoice(choiceIndex, encounterRoll(rng));
+}
+
+bool GameSession::resolveChoice(int choiceIndex, int roll) {
+    Node node = tree.getCurrentNode();
+    if (!node.isValid()) return false;
+
+    ChoiceRange choices = node.getChoicesWithEffects();
+    if (choiceIndex < 0 || choiceIndex >= static_cast<int>(choices.size())) return false;
+    Choice choice = choices[choiceIndex];
+
+    // Save current state for undo BEFORE making changes
+    if (options.trackHistory) {
+        events.saveSchedule(schedule);
+        history.push(node.getId(), state.stats, state.inventory, state.day, state.packSize, &schedule);
+    }
+
+    // Apply the choice's folded effect (one add + clamp), using the
+    // Command pattern when history is kept
+    const StatEffect effect = choice.getEffect();
+    if (options.trackHistory) {
+        if (!effect.isZero()) {
+            actions.executeAndTrack(StatChangeCommand(&state.stats, effect, node.getId(), choiceIndex),
+                                    "Choice Effect");
+        }
+    } else {
+        state.stats.applyEffect(effect);
+    }
+
+    if (listener) {
+        std::string_view text = choice.getText();
+        std::string message = "Choice made: ";
+        message.append(text.substr(0, 40));
+        message += "...";
+        notify(SessionMessage::ChoiceMade, message);
+    }
+
+    // Navigate to next node
+    tree.makeChoice(choiceIndex);
+    state.currentNodeId = tree.getCurrentNodeId();
+
+    // Advance day and apply passive effects and modifiers
+    state.day++;
+    state.stats.setHunger(state.stats.getHunger() + 5);
+    state.stats.setStamina(state.stats.getStamina() - 10);
+    events.getModifiers().step(state.stats);
+    state.stats.validateStats();
+    EventTrace::setContext(state.day, state.currentNodeId);
+
+    // Queue timers that came due today
+    events.setDay(state.day);
+
+    // Trigger node events
+    Node newNode = tree.getCurrentNode();
+    if (newNode.isValid()) {
+        for (int eventId : newNode.getTriggers()) {
+            if (const Event* evt = events.dispatchNow(eventId)) {
+                state.stats.applyEffect(evt->getEffect());
+                if (options.keepEventLog) {
+                    eventLog.emplace_back(evt->getId(), std::string(evt->getDescription()),
+                                          evt->getPriority(), evt->getEffect());
+                }
+            }
+        }
+    }
+
+    // Generate random events
+    generateRandomEvent(roll);
+
+    // Poll stats for critical events (Algorithm 2, Ch 5.2)
+    events.pollStats(&state.stats);
+
+    if (options.keepStatHistory) statHistory.days.record(state.stats);
+
+    if (options.verbose) {
+        std::cout << "DAY " << state.day << ": Moved to Node "
+                  << state.currentNodeId << std::endl;
+    }
+    return true;
+}
+
+// Dispatch queued events (Algorithm 2)
+void GameSession::tick() {
+    // Always runs: update() also takes in events posted by other threads
+    events.update(&state.stats, [this](std::string_view msg) {
+        if (options.keepEventLog) {
+            eventLog.push_back(Event(999, std::string(msg), Priority::HIGH, StatEffect()));
+        }
+        notify(SessionMessage::EventApplied, msg);
+    });
+    if (options.keepStatHistory) statHistory.ticks.record(state.stats);
+}
+
+void GameSession::drainEvents() {
+    do {
+        tick();
+    } while (events.hasEvents());
+}
+
+bool GameSession::step(int choiceIndex) {
+    if (!choose(choiceIndex)) return false;
+    drainEvents();
+    return true;
+}
+
+// ---------------- History ----------------
+bool GameSession::undo() {
+    // Restores the complete game state, inventory included
+    if (!history.undo(state, &schedule)) {
+        notify(SessionMessage::NothingToUndo, "Cannot undo - no history!");
+        return false;
+    }
+
+    // Timers scheduled since (the wound from an undone ice crack) go
+    // away and earlier ones are due on their original days again;
+    // modifiers come back with the days they had left
+    events.restoreSchedule(state.day, schedule);
+
+    tree.setCurrentNode(state.currentNodeId);
+    EventTrace::setContext(state.day, state.currentNodeId);
+
+    notify(SessionMessage::StateRestored, "⟲ Restored previous state");
+    if (options.verbose) {
+        std::cout << "UNDO: Restored to Node " << state.currentNodeId
+                  << " (Day " << state.day << ")" << std::endl;
+    }
+    return true;
+}
+
+void GameSession::clearHistory() {
+    history.clear();
+    actions.clear();
+    notify(SessionMessage::HistoryCleared, "History cleared!");
+    if (options.verbose) {
+        std::cout << "Cleared all undo history" << std::endl;
+    }
+}
+
+// ---------------- Queries ----------------
+bool GameSession::isOver() const {
+    Node node = tree.getCurrentNode();
+    return (node.isValid() && node.isEndingNode()) || state.stats.isDead();
+}
+
+std::string_view GameSession::getEndingText() const {
+    Node node = tree.getCurrentNode();
+    if (node.isValid() && node.isEndingNode()) return node.getEndingType();
+    return "You have perished in the wilderness...";
+}
+
+GameState& GameSession::getState() { return state; }
+const GameState& GameSession::getState() const { return state; }
+DecisionTree& GameSession::getTree() { return tree; }
+EventManager& GameSession::getEvents() { return events; }
+GameStateStack& GameSession::getHistory() { return history; }
+ActionQueue& GameSession::getActions() { return actions; }
+ModifierPool& GameSession::getModifiers() { return events.getModifiers(); }
+const StatHistory& GameSession::getStatHistory() const { return statHistory; }
+std::vector<Event>& GameSession::getEventLog() { return eventLog; }
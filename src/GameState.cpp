@@ -1,81 +1,169 @@
 #include "GameState.h"
+#include <algorithm>
 
-GameStateNode::GameStateNode(int nodeId, const Stats& s, Inventory* inv, int d, int pack)
-    : currentNodeId(nodeId), stats(s), inventory(nullptr), day(d), packSize(pack), next(nullptr) {
-    if (inv) {
-        inventory = new Inventory(*inv);
+// ============================================================
+// GameStateStack Implementation
+// ============================================================
+
+namespace {
+    // Field mask bits; stat i is bit STAT_BIT + i
+    const uint32_t NODE_BIT = 1u << 0;
+    const int STAT_BIT = 1;
+    const uint32_t PACK_BIT = 1u << (STAT_BIT + STAT_COUNT);
+    const uint32_t DAY_BIT = PACK_BIT << 1;         // day is one earlier unless set
+    const uint32_t INVENTORY_BIT = PACK_BIT << 2;
+    const uint32_t TIMERS_BIT = PACK_BIT << 3;
+    const uint32_t RULES_BIT = PACK_BIT << 4;
+    const uint32_t MODIFIERS_BIT = PACK_BIT << 5;
+
+    void putVarint(std::vector<uint8_t>& out, uint32_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
     }
-}
 
-GameStateNode::~GameStateNode() {
-    delete inventory;
-}
+    uint32_t getVarint(const uint8_t*& in) {
+        uint32_t value = 0;
+        for (int shift = 0;; shift += 7) {
+            uint8_t byte = *in++;
+            value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return value;
+        }
+    }
 
-GameStateStack::GameStateStack() : top(nullptr), size(0) {}
+    // Small magnitudes of either sign encode in one byte
+    void putSigned(std::vector<uint8_t>& out, int value) {
+        putVarint(out, (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31));
+    }
 
-GameStateStack::~GameStateStack() {
-    clear();
-}
+    int getSigned(const uint8_t*& in) {
+        uint32_t value = getVarint(in);
+        return static_cast<int>(value >> 1) ^ -static_cast<int>(value & 1);
+    }
+
+    size_t varintSize(uint32_t value) {
+        size_t bytes = 1;
+        while (value >= 0x80) {
+            value >>= 7;
+            ++bytes;
+        }
+        return bytes;
+    }
+
+    // Step lengths are varints with the low group last, so they can be
+    // read from the end of the journal
+    void putLength(std::vector<uint8_t>& out, uint32_t value) {
+        const size_t bytes = varintSize(value);
+        for (size_t i = bytes; i-- > 0;) {
+            const uint8_t group = static_cast<uint8_t>((value >> (7 * i)) & 0x7F);
+            out.push_back(i + 1 < bytes ? static_cast<uint8_t>(group | 0x80) : group);
+        }
+    }
+
+    // Read the length that ends at 'end' and move 'end' to its first byte
+    uint32_t getLengthBefore(const std::vector<uint8_t>& journal, size_t& end) {
+        uint32_t value = 0;
+        for (int shift = 0;; shift += 7) {
+            const uint8_t byte = journal[--end];
+            value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return value;
+        }
+    }
 
-void GameStateStack::push(int nodeId, const Stats& stats, Inventory* inventory, int day, int packSize) {
-    if (size >= MAX_SIZE) {
-        // Remove oldest (bottom of stack)
-        if (top) {
-            GameStateNode* current = top;
-            GameStateNode* prev = nullptr;
-            while (current->next) {
-                prev = current;
-                current = current->next;
+    // Indices of the entries only 'newer' has and of those only 'older'
+    // has; both lists are sorted, so one merge walk finds them
+    template <typename T>
+    void diffSorted(const std::vector<T>& older, const std::vector<T>& newer,
+                    std::vector<uint32_t>& removed, std::vector<uint32_t>& added) {
+        removed.clear();
+        added.clear();
+        size_t i = 0, j = 0;
+        while (i < older.size() || j < newer.size()) {
+            if (j == newer.size() || (i < older.size() && older[i] < newer[j])) {
+                added.push_back(static_cast<uint32_t>(i++));
+            } else if (i == older.size() || newer[j] < older[i]) {
+                removed.push_back(static_cast<uint32_t>(j++));
+            } else {
+                ++i;
+                ++j;
             }
-            if (prev) {
-                prev->next = nullptr;
-                delete current;
-                size--;
+        }
+    }
+
+    // Drop the entries at the gap-coded indices that follow in 'in'
+    template <typename T>
+    void dropIndices(const uint8_t*& in, std::vector<T>* entries) {
+        const uint32_t removed = getVarint(in);
+        size_t kept = 0, next = 0;
+        for (uint32_t i = 0; i < removed; ++i) {
+            const size_t index = next + getVarint(in);
+            if (entries) {
+                for (; next < index; ++next) (*entries)[kept++] = (*entries)[next];
             }
+            next = index + 1;
+        }
+        if (entries) {
+            for (; next < entries->size(); ++next) (*entries)[kept++] = (*entries)[next];
+            entries->resize(kept);
         }
     }
-    
-    GameStateNode* newNode = new GameStateNode(nodeId, stats, inventory, day, packSize);
-    newNode->next = top;
-    top = newNode;
+
+    bool sameItems(const Inventory& a, const Inventory& b) {
+        const InventoryNode* x = a.getHead();
+        const InventoryNode* y = b.getHead();
+        for (; x && y; x = x->next, y = y->next) {
+            if (x->name != y->name || x->type != y->type ||
+                x->effect != y->effect || x->quantity != y->quantity) return false;
+        }
+        return x == y;
+    }
+}
+
+GameStateStack::GameStateStack() : size(0) {}
+
+void GameStateStack::push(int nodeId, const Stats& stats, Inventory* inventory, int day, int packSize,
+                          const DaySchedule* schedule) {
+    Snapshot newer;
+    newer.nodeId = nodeId;
+    newer.stats = stats;
+    newer.day = day;
+    newer.packSize = packSize;
+    if (inventory) newer.inventory = *inventory;
+    if (schedule) newer.schedule = *schedule;
+
+    if (size > 0) writeStep(latest, newer);
+    latest.nodeId = newer.nodeId;
+    latest.stats = newer.stats;
+    latest.day = newer.day;
+    latest.packSize = newer.packSize;
+    if (!sameItems(latest.inventory, newer.inventory)) latest.inventory = newer.inventory;
+    if (!(latest.schedule == newer.schedule)) latest.schedule = newer.schedule;
     size++;
+
+    if (size > MAX_SIZE) dropOldest();
 }
 
-bool GameStateStack::pop(int& outNodeId, Stats& outStats, Inventory*& outInventory, int& outDay, int& outPackSize) {
+bool GameStateStack::undo(GameState& outState, DaySchedule* schedule) {
     if (isEmpty()) return false;
-    
-    GameStateNode* temp = top;
-    outNodeId = temp->currentNodeId;
-    outStats = temp->stats;
-    outInventory = temp->inventory;
-    outDay = temp->day;
-    outPackSize = temp->packSize;
-    
-    top = top->next;
-    temp->inventory = nullptr; // Transfer ownership
-    delete temp;
-    size--;
-    
-    return true;
-}
 
-bool GameStateStack::undo(GameState& outState) {
-    int nodeId, day, packSize;
-    Stats stats;
-    Inventory* inv;
-    
-    if (!pop(nodeId, stats, inv, day, packSize)) {
-        return false;
-    }
-    
-    outState.currentNodeId = nodeId;
-    outState.stats = stats;
-    outState.day = day;
-    outState.packSize = packSize;
-    
-    delete outState.inventory;
-    outState.inventory = inv;
-    
+    outState.currentNodeId = latest.nodeId;
+    outState.stats = latest.stats;
+    outState.day = latest.day;
+    outState.packSize = latest.packSize;
+    if (outState.inventory) *outState.inventory = latest.inventory;
+    if (schedule) *schedule = latest.schedule;
+
+    // Step the whole state back to the one saved before it
+    if (!journal.empty()) {
+        size_t end = journal.size();
+        const uint32_t length = getLengthBefore(journal, end);
+        const size_t begin = end - length;
+        readStep(begin, &latest);
+        journal.resize(begin);
+    }
+    size--;
     return true;
 }
 
@@ -84,22 +172,249 @@ int GameStateStack::getSize() const {
 }
 
 bool GameStateStack::isEmpty() const {
-    return top == nullptr;
+    return size == 0;
 }
 
 void GameStateStack::clear() {
-    while (!isEmpty()) {
-        int dummy1, dummy2, dummy3;
-        Stats dummyStats;
-        Inventory* dummyInv;
-        pop(dummy1, dummyStats, dummyInv, dummy2, dummy3);
-        delete dummyInv;
+    journal.clear();
+    kinds.clear();
+    latest.inventory.clear();
+    latest.schedule.clear();
+    size = 0;
+}
+
+size_t GameStateStack::getJournalSize() const {
+    return journal.size();
+}
+
+size_t GameStateStack::getMemoryUsage() const {
+    size_t bytes = sizeof(*this) + journal.capacity() + kinds.capacity() * sizeof(ItemKind);
+    for (const ItemKind& kind : kinds) bytes += kind.name.capacity() + kind.type.capacity();
+    bytes += latest.schedule.timers.capacity() * sizeof(DayTimer) + latest.schedule.ruleArmed.capacity();
+    bytes += latest.schedule.modifiers.capacity() * sizeof(DayModifier);
+    return bytes + static_cast<size_t>(latest.inventory.getSize()) * sizeof(InventoryNode);
+}
+
+// ---------------- Encoding ----------------
+
+// Append the step that turns 'newer' back into 'older'
+void GameStateStack::writeStep(const Snapshot& older, const Snapshot& newer) {
+    const size_t begin = journal.size();
+    const StatEffect delta = older.stats.getValues() - newer.stats.getValues();
+    const bool itemsChanged = !sameItems(older.inventory, newer.inventory);
+    const bool timersChanged = older.schedule.timers != newer.schedule.timers;
+    const bool modifiersChanged = older.schedule.modifiers != newer.schedule.modifiers;
+    const bool rulesChanged = older.schedule.ruleArmed != newer.schedule.ruleArmed;
+
+    uint32_t mask = 0;
+    if (older.nodeId != newer.nodeId) mask |= NODE_BIT;
+    for (int s = 0; s < STAT_COUNT; ++s) {
+        if (delta.lanes[s] != 0) mask |= 1u << (STAT_BIT + s);
+    }
+    if (older.packSize != newer.packSize) mask |= PACK_BIT;
+    if (older.day != newer.day - 1) mask |= DAY_BIT;
+    if (itemsChanged) mask |= INVENTORY_BIT;
+    if (timersChanged) mask |= TIMERS_BIT;
+    if (rulesChanged) mask |= RULES_BIT;
+    if (modifiersChanged) mask |= MODIFIERS_BIT;
+
+    putVarint(journal, mask);
+    if (mask & NODE_BIT) putSigned(journal, older.nodeId - newer.nodeId);
+    for (int s = 0; s < STAT_COUNT; ++s) {
+        if (delta.lanes[s] != 0) putSigned(journal, delta.lanes[s]);
     }
+    if (mask & PACK_BIT) putSigned(journal, older.packSize - newer.packSize);
+    if (mask & DAY_BIT) putSigned(journal, older.day - newer.day);
+    if (itemsChanged) writeInventory(older.inventory);
+    if (timersChanged) writeTimers(older.schedule.timers, newer.schedule.timers, older.day);
+    if (rulesChanged) writeRules(older.schedule.ruleArmed, newer.schedule.ruleArmed);
+    if (modifiersChanged) writeModifiers(older.schedule.modifiers, newer.schedule.modifiers, older.day);
+
+    putLength(journal, static_cast<uint32_t>(journal.size() - begin));
+}
+
+// Items tail first, so re-adding them (each goes to the head) restores
+// the list order
+void GameStateStack::writeInventory(const Inventory& inventory) {
+    const InventoryNode* items[10];
+    int count = 0;
+    for (const InventoryNode* item = inventory.getHead(); item && count < 10; item = item->next) {
+        items[count++] = item;
+    }
+    putVarint(journal, static_cast<uint32_t>(count));
+    while (count > 0) {
+        const InventoryNode* item = items[--count];
+        putVarint(journal, kindOf(*item));
+        putVarint(journal, static_cast<uint32_t>(item->quantity));
+    }
+}
+
+// The timers of 'newer' that 'older' lacks, as gaps between their
+// indices, then the ones only 'older' has, due days relative to 'day'
+void GameStateStack::writeTimers(const std::vector<DayTimer>& older, const std::vector<DayTimer>& newer, int day) {
+    diffSorted(older, newer, removedEntries, addedEntries);
+    writeIndices(removedEntries);
+    putVarint(journal, static_cast<uint32_t>(addedEntries.size()));
+    for (uint32_t index : addedEntries) {
+        const DayTimer& timer = older[index];
+        putSigned(journal, timer.eventId);
+        putSigned(journal, timer.dueDay - day);
+        putVarint(journal, timer.period);
+    }
+}
+
+// The same for modifiers. Their days are absolute, so one that only
+// ran a day shorter is unchanged and costs nothing.
+void GameStateStack::writeModifiers(const std::vector<DayModifier>& older, const std::vector<DayModifier>& newer,
+                                    int day) {
+    diffSorted(older, newer, removedEntries, addedEntries);
+    writeIndices(removedEntries);
+    putVarint(journal, static_cast<uint32_t>(addedEntries.size()));
+    for (uint32_t index : addedEntries) {
+        const DayModifier& modifier = older[index];
+        putVarint(journal, modifier.target);
+        putVarint(journal, static_cast<uint32_t>(modifier.kind));
+        putVarint(journal, static_cast<uint32_t>(modifier.stacks));
+        putSigned(journal, modifier.firstDay - day);
+        putSigned(journal, modifier.lastDay - day);
+    }
+}
+
+// Count, then each index as the gap from the one before
+void GameStateStack::writeIndices(const std::vector<uint32_t>& indices) {
+    putVarint(journal, static_cast<uint32_t>(indices.size()));
+    uint32_t next = 0;
+    for (uint32_t index : indices) {
+        putVarint(journal, index - next);
+        next = index + 1;
+    }
+}
+
+// Rule count, then the rules whose flag differs, as gaps between their
+// indices; a rule 'newer' does not have counts as armed
+void GameStateStack::writeRules(const std::vector<uint8_t>& older, const std::vector<uint8_t>& newer) {
+    removedEntries.clear();    // reused for the flipped indices
+    for (size_t r = 0; r < older.size(); ++r) {
+        const bool armed = r < newer.size() ? newer[r] != 0 : true;
+        if ((older[r] != 0) != armed) removedEntries.push_back(static_cast<uint32_t>(r));
+    }
+
+    putVarint(journal, static_cast<uint32_t>(older.size()));
+    writeIndices(removedEntries);
 }
 
-Inventory* GameStateStack::copyInventory(Inventory* original) {
-    if (!original) return nullptr;
-    Inventory* copy = new Inventory();
-    // Deep copy implementation would go here
-    return copy;
-}
\ No newline at end of file
+uint32_t GameStateStack::kindOf(const InventoryNode& item) {
+    for (size_t i = 0; i < kinds.size(); ++i) {
+        if (kinds[i].name == item.name && kinds[i].type == item.type && kinds[i].effect == item.effect) {
+            return static_cast<uint32_t>(i);
+        }
+    }
+    kinds.push_back({ item.name, item.type, item.effect });
+    return static_cast<uint32_t>(kinds.size() - 1);
+}
+
+// ---------------- Decoding ----------------
+
+// Decode the step at 'begin', applying it to 'state' unless null.
+// Returns the offset just past the step.
+size_t GameStateStack::readStep(size_t begin, Snapshot* state) const {
+    const uint8_t* in = journal.data() + begin;
+    const uint32_t mask = getVarint(in);
+
+    int node = 0, pack = 0, day = -1;
+    StatEffect delta;
+    if (mask & NODE_BIT) node = getSigned(in);
+    for (int s = 0; s < STAT_COUNT; ++s) {
+        if (mask & (1u << (STAT_BIT + s))) delta.lanes[s] = getSigned(in);
+    }
+    if (mask & PACK_BIT) pack = getSigned(in);
+    if (mask & DAY_BIT) day = getSigned(in);
+
+    if (state) {
+        state->nodeId += node;
+        // The result is a previously saved value, so nothing clamps
+        state->stats.applyEffect(delta);
+        state->packSize += pack;
+        state->day += day;
+    }
+
+    if (mask & INVENTORY_BIT) {
+        if (state) state->inventory.clear();
+        uint32_t count = getVarint(in);
+        for (uint32_t i = 0; i < count; ++i) {
+            const ItemKind& kind = kinds[getVarint(in)];
+            int quantity = static_cast<int>(getVarint(in));
+            if (state) state->inventory.addItem(kind.name, kind.type, kind.effect, quantity);
+        }
+    }
+
+    // Timers and modifiers are relative to the older state's day,
+    // already restored above
+    if (mask & TIMERS_BIT) {
+        std::vector<DayTimer>* timers = state ? &state->schedule.timers : nullptr;
+        dropIndices(in, timers);
+        const size_t kept = timers ? timers->size() : 0;
+        const uint32_t added = getVarint(in);
+        for (uint32_t i = 0; i < added; ++i) {
+            DayTimer timer;
+            timer.eventId = getSigned(in);
+            timer.dueDay = getSigned(in);
+            timer.period = getVarint(in);
+            if (timers) {
+                timer.dueDay += state->day;
+                timers->push_back(timer);
+            }
+        }
+        if (timers) std::inplace_merge(timers->begin(), timers->begin() + static_cast<std::ptrdiff_t>(kept), timers->end());
+    }
+
+    if (mask & RULES_BIT) {
+        std::vector<uint8_t>* flags = state ? &state->schedule.ruleArmed : nullptr;
+        const uint32_t rules = getVarint(in);
+        if (flags) flags->resize(rules, 1);
+        const uint32_t flipped = getVarint(in);
+        uint32_t next = 0;
+        for (uint32_t i = 0; i < flipped; ++i) {
+            const uint32_t r = next + getVarint(in);
+            if (flags) (*flags)[r] = (*flags)[r] ? 0 : 1;
+            next = r + 1;
+        }
+    }
+
+    if (mask & MODIFIERS_BIT) {
+        std::vector<DayModifier>* modifiers = state ? &state->schedule.modifiers : nullptr;
+        dropIndices(in, modifiers);
+        const size_t kept = modifiers ? modifiers->size() : 0;
+        const uint32_t added = getVarint(in);
+        for (uint32_t i = 0; i < added; ++i) {
+            DayModifier modifier;
+            modifier.target = getVarint(in);
+            modifier.kind = static_cast<int>(getVarint(in));
+            modifier.stacks = static_cast<int>(getVarint(in));
+            modifier.firstDay = getSigned(in);
+            modifier.lastDay = getSigned(in);
+            if (modifiers) {
+                modifier.firstDay += state->day;
+                modifier.lastDay += state->day;
+                modifiers->push_back(modifier);
+            }
+        }
+        if (modifiers) {
+            std::inplace_merge(modifiers->begin(), modifiers->begin() + static_cast<std::ptrdiff_t>(kept),
+                               modifiers->end());
+        }
+    }
+
+    const size_t length = static_cast<size_t>(in - (journal.data() + begin));
+    return begin + length + varintSize(static_cast<uint32_t>(length));
+}
+
+void GameStateStack::dropOldest() {
+    size_t end = 0;
+    int dropped = 0;
+    for (; dropped < MAX_SIZE / 8 && end < journal.size(); ++dropped) {
+        end = readStep(end, nullptr);
+    }
+    journal.erase(journal.begin(), journal.begin() + static_cast<std::ptrdiff_t>(end));
+    size -= dropped;
+}
@@ -0,0 +1,295 @@
+#include "GraphExporter.h"
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <unordered_set>
+
+using namespace StoryFormat;
+
+namespace {
+
+// ---------------- Buffered output ----------------
+
+class OutputBuffer {
+public:
+    static const size_t CAPACITY = 1 << 20;
+
+    explicit OutputBuffer(const std::string& filename)
+        : file(std::fopen(filename.c_str(), "wb")), used(0), ok(file != nullptr) {
+        if (ok) buffer.resize(CAPACITY);
+    }
+
+    ~OutputBuffer() {
+        close();
+    }
+
+    bool isOpen() const { return file != nullptr; }
+
+    void put(char c) {
+        if (used == CAPACITY) flush();
+        buffer[used++] = c;
+    }
+
+    void put(std::string_view s) {
+        putRaw(s.data(), s.size());
+    }
+
+    void putInt(int64_t value) {
+        char digits[24];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        putRaw(digits, static_cast<size_t>(result.ptr - digits));
+    }
+
+    void putRaw(const void* data, size_t size) {
+        const char* bytes = static_cast<const char*>(data);
+        while (size > 0) {
+            if (used == CAPACITY) flush();
+            size_t chunk = std::min(size, CAPACITY - used);
+            std::copy(bytes, bytes + chunk, buffer.data() + used);
+            used += chunk;
+            bytes += chunk;
+            size -= chunk;
+        }
+    }
+
+    template <typename T>
+    void putValue(const T& value) {
+        putRaw(&value, sizeof(T));
+    }
+
+    // XML character data / attribute value
+    void putEscaped(std::string_view s) {
+        for (char c : s) {
+            switch (c) {
+                case '&': put("&amp;"); break;
+                case '<': put("&lt;"); break;
+                case '>': put("&gt;"); break;
+                case '"': put("&quot;"); break;
+                case '\'': put("&apos;"); break;
+                default: put(c); break;
+            }
+        }
+    }
+
+    bool close() {
+        if (!file) return ok;
+        flush();
+        if (std::fclose(file) != 0) ok = false;
+        file = nullptr;
+        return ok;
+    }
+
+private:
+    std::FILE* file;
+    std::vector<char> buffer;
+    size_t used;
+    bool ok;
+
+    void flush() {
+        if (ok && used > 0) ok = std::fwrite(buffer.data(), 1, used, file) == used;
+        used = 0;
+    }
+};
+
+// ---------------- Node selection ----------------
+
+// Either every node or a sorted subset; positions are the exported order
+class NodeSet {
+public:
+    NodeSet(const NodeStore& store, const std::vector<uint32_t>* subset)
+        : subset(subset), total(store.getNodeCount()) {}
+
+    uint32_t size() const {
+        return subset ? static_cast<uint32_t>(subset->size()) : total;
+    }
+
+    uint32_t nodeAt(uint32_t position) const {
+        return subset ? (*subset)[position] : position;
+    }
+
+    // Position of a dense node index, NO_INDEX if not exported
+    uint32_t positionOf(uint32_t index) const {
+        if (!subset) return index;
+        auto it = std::lower_bound(subset->begin(), subset->end(), index);
+        return (it != subset->end() && *it == index) ? static_cast<uint32_t>(it - subset->begin()) : NO_INDEX;
+    }
+
+private:
+    const std::vector<uint32_t>* subset;
+    uint32_t total;
+};
+
+// ---------------- Formats ----------------
+
+void writeDot(const NodeStore& store, const NodeSet& set, OutputBuffer& out) {
+    out.put("digraph DecisionTree {\n  rankdir=TB;\n  node [shape=box, style=rounded];\n\n");
+
+    for (uint32_t p = 0; p < set.size(); ++p) {
+        const NodeRecord& rec = store.getNode(set.nodeAt(p));
+        const bool ending = (rec.flags & NODE_ENDING) != 0;
+        out.put("  node");
+        out.putInt(rec.id);
+        out.put(" [label=\"Node ");
+        out.putInt(rec.id);
+        out.put(ending ? "\", shape=doubleoctagon, color=red, style=filled, fillcolor=lightpink];\n"
+                       : "\", shape=box];\n");
+    }
+
+    out.put("\n");
+
+    for (uint32_t p = 0; p < set.size(); ++p) {
+        const NodeRecord& rec = store.getNode(set.nodeAt(p));
+        for (uint32_t c = 0; c < rec.choiceCount; ++c) {
+            const ChoiceRecord& choice = store.getChoice(rec.firstChoice + c);
+            if (set.positionOf(choice.targetIndex) == NO_INDEX) continue;
+            out.put("  node");
+            out.putInt(rec.id);
+            out.put(" -> node");
+            out.putInt(choice.targetNodeId);
+            out.put(" [label=\"");
+            out.put(static_cast<char>('A' + c));
+            out.put("\"];\n");
+        }
+    }
+
+    out.put("}\n");
+}
+
+void writeGraphML(const NodeStore& store, const NodeSet& set, OutputBuffer& out) {
+    out.put("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+            "<graphml xmlns=\"http://graphml.graphdrawing.org/xmlns\">\n"
+            "  <key id=\"text\" for=\"node\" attr.name=\"text\" attr.type=\"string\"/>\n"
+            "  <key id=\"ending\" for=\"node\" attr.name=\"ending\" attr.type=\"string\"/>\n"
+            "  <key id=\"choice\" for=\"edge\" attr.name=\"choice\" attr.type=\"string\"/>\n"
+            "  <graph id=\"story\" edgedefault=\"directed\">\n");
+
+    for (uint32_t p = 0; p < set.size(); ++p) {
+        const NodeRecord& rec = store.getNode(set.nodeAt(p));
+        out.put("    <node id=\"n");
+        out.putInt(rec.id);
+        out.put("\"><data key=\"text\">");
+        out.putEscaped(store.getString(rec.textOffset, rec.textLength));
+        out.put("</data>");
+        if (rec.flags & NODE_ENDING) {
+            out.put("<data key=\"ending\">");
+            out.putEscaped(store.getString(rec.endingOffset, rec.endingLength));
+            out.put("</data>");
+        }
+        out.put("</node>\n");
+    }
+
+    for (uint32_t p = 0; p < set.size(); ++p) {
+        const NodeRecord& rec = store.getNode(set.nodeAt(p));
+        for (uint32_t c = rec.firstChoice; c < rec.firstChoice + rec.choiceCount; ++c) {
+            const ChoiceRecord& choice = store.getChoice(c);
+            if (set.positionOf(choice.targetIndex) == NO_INDEX) continue;
+            out.put("    <edge source=\"n");
+            out.putInt(rec.id);
+            out.put("\" target=\"n");
+            out.putInt(choice.targetNodeId);
+            out.put("\"><data key=\"choice\">");
+            out.putEscaped(store.getString(choice.textOffset, choice.textLength));
+            out.put("</data></edge>\n");
+        }
+    }
+
+    out.put("  </graph>\n</graphml>\n");
+}
+
+void writeCsr(const NodeStore& store, const NodeSet& set, OutputBuffer& out) {
+    // Edge count first (edges leaving the exported set are dropped)
+    uint32_t edgeCount = 0;
+    for (uint32_t p = 0; p < set.size(); ++p) {
+        const NodeRecord& rec = store.getNode(set.nodeAt(p));
+        for (uint32_t c = rec.firstChoice; c < rec.firstChoice + rec.choiceCount; ++c) {
+            if (set.positionOf(store.getChoice(c).targetIndex) != NO_INDEX) ++edgeCount;
+        }
+    }
+
+    CsrHeader header = {GraphExporter::CSR_MAGIC, GraphExporter::CSR_VERSION, set.size(), edgeCount};
+    out.putValue(header);
+
+    for (uint32_t p = 0; p < set.size(); ++p) {
+        out.putValue(static_cast<int32_t>(store.getNode(set.nodeAt(p)).id));
+    }
+    for (uint32_t p = 0; p < set.size(); ++p) {
+        out.putValue(static_cast<uint8_t>(store.getNode(set.nodeAt(p)).flags & NODE_ENDING ? 1 : 0));
+    }
+    static const char padding[4] = {};
+    out.putRaw(padding, (4 - set.size() % 4) % 4);
+
+    uint32_t offset = 0;
+    out.putValue(offset);
+    for (uint32_t p = 0; p < set.size(); ++p) {
+        const NodeRecord& rec = store.getNode(set.nodeAt(p));
+        for (uint32_t c = rec.firstChoice; c < rec.firstChoice + rec.choiceCount; ++c) {
+            if (set.positionOf(store.getChoice(c).targetIndex) != NO_INDEX) ++offset;
+        }
+        out.putValue(offset);
+    }
+
+    for (uint32_t p = 0; p < set.size(); ++p) {
+        const NodeRecord& rec = store.getNode(set.nodeAt(p));
+        for (uint32_t c = rec.firstChoice; c < rec.firstChoice + rec.choiceCount; ++c) {
+            uint32_t target = set.positionOf(store.getChoice(c).targetIndex);
+            if (target != NO_INDEX) out.putValue(target);
+        }
+    }
+}
+
+bool writeSet(const NodeStore& store, const NodeSet& set, const std::string& filename, GraphFormat format) {
+    if (!store.isFinalized()) return false;
+
+    OutputBuffer out(filename);
+    if (!out.isOpen()) return false;
+
+    switch (format) {
+        case GraphFormat::Dot:       writeDot(store, set, out); break;
+        case GraphFormat::GraphML:   writeGraphML(store, set, out); break;
+        case GraphFormat::BinaryCsr: writeCsr(store, set, out); break;
+    }
+    return out.close();
+}
+
+}
+
+namespace GraphExporter {
+
+bool write(const NodeStore& store, const std::string& filename, GraphFormat format) {
+    return writeSet(store, NodeSet(store, nullptr), filename, format);
+}
+
+bool writeSubgraph(const NodeStore& store, const std::vector<uint32_t>& nodes,
+                   const std::string& filename, GraphFormat format) {
+    return writeSet(store, NodeSet(store, &nodes), filename, format);
+}
+
+std::vector<uint32_t> neighborhood(const NodeStore& store, uint32_t center, int hops) {
+    std::vector<uint32_t> result;
+    if (center >= store.getNodeCount()) return result;
+
+    std::unordered_set<uint32_t> seen;
+    std::vector<uint32_t> frontier(1, center), next;
+    seen.insert(center);
+    result.push_back(center);
+
+    for (int hop = 0; hop < hops && !frontier.empty(); ++hop) {
+        next.clear();
+        for (uint32_t n : frontier) {
+            const NodeRecord& rec = store.getNode(n);
+            for (uint32_t c = rec.firstChoice; c < rec.firstChoice + rec.choiceCount; ++c) {
+                uint32_t target = store.getChoice(c).targetIndex;
+                if (seen.insert(target).second) {
+                    next.push_back(target);
+                    result.push_back(target);
+                }
+            }
+        }
+        frontier.swap(next);
+    }
+
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+}
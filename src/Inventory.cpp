@@ -7,6 +7,24 @@ InventoryNode::InventoryNode(const std::string& n, const std::string& t, int e,
 
 Inventory::Inventory() : head(nullptr), size(0) {}
 
+Inventory::Inventory(const Inventory& other) : head(nullptr), size(0) {
+    *this = other;
+}
+
+Inventory& Inventory::operator=(const Inventory& other) {
+    if (this == &other) return *this;
+    clear();
+
+    // Copy nodes in order
+    InventoryNode** tail = &head;
+    for (InventoryNode* current = other.head; current != nullptr; current = current->next) {
+        *tail = new InventoryNode(current->name, current->type, current->effect, current->quantity);
+        tail = &(*tail)->next;
+    }
+    size = other.size;
+    return *this;
+}
+
 Inventory::~Inventory() {
     clear();
 }
@@ -0,0 +1,222 @@
+#include "ModifierPool.h"
+#include <algorithm>
+
+// ============================================================
+// ModifierPool Implementation
+// New entries are appended unsorted; lookups binary-search the sorted
+// front and scan the short tail added since the last merge.
+// ============================================================
+
+namespace {
+    const int STAT_MAX = 100;
+    const size_t TAIL_LIMIT = 64;
+
+    // Effect of one stack at 'age' steps
+    StatEffect effectAt(const ModifierType& type, int age) {
+        StatEffect effect = type.effect;
+        switch (type.decay) {
+        case Decay::None:
+            break;
+        case Decay::Linear: {
+            const int left = type.duration - age;
+            for (int i = 0; i < StatEffect::LANES; ++i) effect.lanes[i] = effect.lanes[i] * left / type.duration;
+            break;
+        }
+        case Decay::Halving: {
+            const int32_t divisor = 1 << (age < 30 ? age : 30);
+            for (int i = 0; i < StatEffect::LANES; ++i) effect.lanes[i] /= divisor;
+            break;
+        }
+        }
+        return effect;
+    }
+}
+
+ModifierPool::ModifierPool() : sorted(0), nextOrder(0) {}
+
+// ---------------- Kinds ----------------
+
+int ModifierPool::defineType(const ModifierType& type) {
+    if (type.duration == 0) return -1;
+    types.push_back(type);
+    if (types.back().maxStacks == 0) types.back().maxStacks = 1;
+
+    // The decay curve is tabulated once, so the sweep never divides
+    curveStart.push_back(static_cast<uint32_t>(curves.size()));
+    for (int age = 0; age < type.duration; ++age) curves.push_back(effectAt(type, age));
+    return static_cast<int>(types.size() - 1);
+}
+
+const ModifierType* ModifierPool::findType(int kind) const {
+    if (kind < 0 || kind >= static_cast<int>(types.size())) return nullptr;
+    return &types[kind];
+}
+
+void ModifierPool::reserve(size_t count) {
+    active.reserve(count);
+    merged.reserve(count);
+    totals.reserve(count);
+}
+
+// ---------------- Applying ----------------
+
+bool ModifierPool::add(uint32_t target, int kind) {
+    const ModifierType* type = findType(kind);
+    if (!type) return false;
+
+    const uint16_t k = static_cast<uint16_t>(kind);
+    if (type->stacking != Stacking::Independent) {
+        if (Modifier* existing = find(target, k)) {
+            if (type->stacking == Stacking::Stack && existing->stacks < type->maxStacks) ++existing->stacks;
+            existing->age = 0;
+            existing->remaining = type->duration;
+            return true;
+        }
+    }
+    active.push_back({ target, k, 1, 0, type->duration, nextOrder++ });
+
+    // Keep the unsorted tail short so lookups stay cheap
+    if (active.size() - sorted > TAIL_LIMIT + sorted / 64) sort();
+    return true;
+}
+
+size_t ModifierPool::remove(uint32_t target, int kind) {
+    size_t out = 0;
+    size_t keptSorted = 0;
+    for (size_t i = 0; i < active.size(); ++i) {
+        if (active[i].target == target && active[i].kind == kind) continue;
+        if (i < sorted) ++keptSorted;
+        active[out++] = active[i];
+    }
+    const size_t removed = active.size() - out;
+    active.resize(out);
+    sorted = keptSorted;
+    return removed;
+}
+
+int ModifierPool::count(uint32_t target, int kind) const {
+    int stacks = 0;
+    for (const Modifier& m : active) {
+        if (m.target == target && m.kind == kind) stacks += m.stacks;
+    }
+    return stacks;
+}
+
+ModifierPool::Modifier* ModifierPool::find(uint32_t target, uint16_t kind) {
+    auto first = active.begin();
+    auto last = first + static_cast<std::ptrdiff_t>(sorted);
+    auto it = std::lower_bound(first, last, target, [kind](const Modifier& m, uint32_t t) {
+        return m.target != t ? m.target < t : m.kind < kind;
+    });
+    if (it != last && it->target == target && it->kind == kind) return &*it;
+    for (it = last; it != active.end(); ++it) {
+        if (it->target == target && it->kind == kind) return &*it;
+    }
+    return nullptr;
+}
+
+// Sort the tail and merge it into the front through a scratch buffer
+// that is kept, so a steady pool does not allocate
+void ModifierPool::sort() {
+    if (sorted == active.size()) return;
+    auto byTarget = [](const Modifier& a, const Modifier& b) {
+        if (a.target != b.target) return a.target < b.target;
+        if (a.kind != b.kind) return a.kind < b.kind;
+        return a.order < b.order;
+    };
+    auto middle = active.begin() + static_cast<std::ptrdiff_t>(sorted);
+    std::sort(middle, active.end(), byTarget);
+    merged.resize(active.size());
+    std::merge(active.begin(), middle, middle, active.end(), merged.begin(), byTarget);
+    active.swap(merged);
+
+    // Renumber so the counter never wraps
+    for (size_t i = 0; i < active.size(); ++i) active[i].order = static_cast<uint32_t>(i);
+    nextOrder = static_cast<uint32_t>(active.size());
+    sorted = active.size();
+}
+
+// ---------------- Sweep ----------------
+
+const std::vector<TargetEffect>& ModifierPool::step() {
+    sort();
+    totals.clear();
+
+    size_t out = 0;
+    for (size_t i = 0; i < active.size(); ++i) {
+        Modifier m = active[i];
+        const StatEffect effect = curves[curveStart[m.kind] + m.age] * m.stacks;
+        if (!effect.isZero()) {
+            if (totals.empty() || totals.back().target != m.target) totals.push_back({ m.target, StatEffect() });
+            totals.back().effect += effect;
+        }
+        ++m.age;
+        if (--m.remaining > 0) active[out++] = m;
+    }
+    active.resize(out);
+    sorted = out;
+    return totals;
+}
+
+void ModifierPool::step(Stats& stats, uint32_t target) {
+    const std::vector<TargetEffect>& changes = step();
+    auto it = std::lower_bound(changes.begin(), changes.end(), target,
+                               [](const TargetEffect& t, uint32_t value) { return t.target < value; });
+    if (it != changes.end() && it->target == target) stats.applyEffect(it->effect);
+}
+
+// Targets are sparse in a large pack, so this scatters into the columns
+// with the same 0..100 clamp as Stats::applyEffect
+void ModifierPool::step(StatsBlock& pack) {
+    const std::vector<TargetEffect>& changes = step();
+    int* xp = pack.xpColumn();
+    for (const TargetEffect& change : changes) {
+        if (change.target >= pack.size()) continue;
+        for (int s = 0; s < STAT_COUNT; ++s) {
+            const int delta = change.effect.lanes[s];
+            if (delta == 0) continue;
+            if (static_cast<StatId>(s) == StatId::XP) {
+                xp[change.target] += delta;
+                continue;
+            }
+            uint8_t& value = pack.column(static_cast<StatId>(s))[change.target];
+            const int v = value + delta;
+            value = static_cast<uint8_t>(v < 0 ? 0 : v > STAT_MAX ? STAT_MAX : v);
+        }
+    }
+}
+
+size_t ModifierPool::size() const {
+    return active.size();
+}
+
+// ---------------- Saved Positions ----------------
+
+void ModifierPool::save(std::vector<DayModifier>& out, int now) const {
+    out.clear();
+    for (const Modifier& m : active) {
+        out.push_back({ m.target, m.kind, m.stacks, now - m.age, now + m.remaining });
+    }
+    std::sort(out.begin(), out.end());
+}
+
+void ModifierPool::restore(const std::vector<DayModifier>& saved, int now) {
+    clear();
+    for (const DayModifier& m : saved) {
+        const ModifierType* type = findType(m.kind);
+        const int age = now - m.firstDay;
+        const int remaining = m.lastDay - now;
+        if (!type || age < 0 || remaining <= 0 || age + remaining != type->duration) continue;
+        const int stacks = m.stacks < 1 ? 1 : m.stacks > type->maxStacks ? type->maxStacks : m.stacks;
+        active.push_back({ m.target, static_cast<uint16_t>(m.kind), static_cast<uint16_t>(stacks),
+                           static_cast<uint16_t>(age), static_cast<uint16_t>(remaining), nextOrder++ });
+    }
+    sort();
+}
+
+void ModifierPool::clear() {
+    active.clear();
+    totals.clear();
+    sorted = 0;
+    nextOrder = 0;
+}
@@ -1,53 +1,80 @@
 #include "Node.h"
-#include <utility>
 
 // ============================================================
-// Node Implementation
+// Choice Implementation
 // ============================================================
 
-Node::Node(int id, const std::string& text, bool isEnding)
-    : id(id), text(text), ending(isEnding), endingType("") {}
+Choice::Choice(const NodeStore* store, uint32_t index)
+    : store(store), index(index) {}
 
-int Node::getId() const { 
-    return id; 
+std::string_view Choice::getText() const {
+    const StoryFormat::ChoiceRecord& rec = store->getChoice(index);
+    return store->getString(rec.textOffset, rec.textLength);
 }
 
-std::string Node::getText() const { 
-    return text; 
+int Choice::getTargetNodeId() const {
+    return store->getChoice(index).targetNodeId;
 }
 
-bool Node::isEndingNode() const { 
-    return ending; 
+uint32_t Choice::getTargetIndex() const {
+    return store->getChoice(index).targetIndex;
 }
 
-std::string Node::getEndingType() const { 
-    return endingType; 
+EffectRange Choice::getEffects() const {
+    const StoryFormat::ChoiceRecord& rec = store->getChoice(index);
+    return EffectRange(store->getEffects() + rec.firstEffect, rec.effectCount);
 }
 
-void Node::addChoice(const std::string& text, int nextNodeId, const std::vector<StatEffect>& effects) {
-    choicesWithEffects.push_back(Choice(text, nextNodeId, effects));
+StatEffect Choice::getEffect() const {
+    const StoryFormat::ChoiceRecord& rec = store->getChoice(index);
+    if (rec.foldedEffect == StoryFormat::NO_INDEX) return StatEffect();
+    return toStatEffect(store->getEffects()[rec.foldedEffect]);
 }
 
-void Node::addTrigger(int eventId) {
-    triggers.push_back(eventId);
+ChoiceRange::ChoiceRange(const NodeStore* store, uint32_t first, uint32_t count)
+    : store(store), first(first), count(count) {}
+
+// ============================================================
+// Node Implementation
+// ============================================================
+
+Node::Node() : store(nullptr), index(StoryFormat::NO_INDEX) {}
+
+Node::Node(const NodeStore* store, uint32_t index)
+    : store(store), index(index) {}
+
+bool Node::isValid() const {
+    return store != nullptr && index < store->getNodeCount();
 }
 
-void Node::setEndingType(const std::string& type) {
-    endingType = type;
+uint32_t Node::getIndex() const {
+    return index;
 }
 
-const std::vector<Choice>& Node::getChoicesWithEffects() const {
-    return choicesWithEffects;
+const StoryFormat::NodeRecord& Node::record() const {
+    return store->getNode(index);
 }
 
-std::vector<std::pair<std::string, int>> Node::getChoices() const {
-    std::vector<std::pair<std::string, int>> result;
-    for (const auto& choice : choicesWithEffects) {
-        result.push_back(std::make_pair(choice.text, choice.targetNodeId));
-    }
-    return result;
+int Node::getId() const {
+    return record().id;
 }
 
-const std::vector<int>& Node::getTriggers() const {
-    return triggers;
-}
\ No newline at end of file
+std::string_view Node::getText() const {
+    return store->getString(record().textOffset, record().textLength);
+}
+
+bool Node::isEndingNode() const {
+    return (record().flags & StoryFormat::NODE_ENDING) != 0;
+}
+
+std::string_view Node::getEndingType() const {
+    return store->getString(record().endingOffset, record().endingLength);
+}
+
+ChoiceRange Node::getChoicesWithEffects() const {
+    return ChoiceRange(store, record().firstChoice, record().choiceCount);
+}
+
+ArrayView<int32_t> Node::getTriggers() const {
+    return ArrayView<int32_t>(store->getTriggers() + record().firstTrigger, record().triggerCount);
+}
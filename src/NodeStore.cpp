@@ -0,0 +1,478 @@
+#include "NodeStore.h"
+#include "StoryImage.h"
+#include <algorithm>
+
+using namespace StoryFormat;
+
+StatEffect toStatEffect(const EffectRecord& e) {
+    return StatEffect(e.health, e.hunger, e.stamina, e.packStatus, e.morale, e.strength, e.xp);
+}
+
+EffectRecord toEffectRecord(const StatEffect& e) {
+    return {e[StatId::Health], e[StatId::Hunger], e[StatId::Stamina], e[StatId::PackStatus],
+            e[StatId::Morale], e[StatId::Strength], e[StatId::XP]};
+}
+
+StatEffect EffectRange::iterator::operator*() const {
+    return toStatEffect(*current);
+}
+
+// ============================================================
+// NodeStore Implementation
+// ============================================================
+
+NodeStore::NodeStore()
+    : nodes(nullptr), choices(nullptr), effects(nullptr), triggers(nullptr),
+      idTable(nullptr), strings(nullptr),
+      nodeCount(0), choiceCount(0), effectCount(0), triggerCount(0),
+      idBase(0), idTableSize(0), stringSize(0),
+      finalized(false), mapped(false), reopened(false) {}
+
+void NodeStore::clear() {
+    buildIndex.clear();
+    stagedChoices.clear();
+    stagedTriggers.clear();
+    danglingChoices.clear();
+    unknownNodeRefs.clear();
+    ownedNodes.clear();
+    ownedChoices.clear();
+    ownedEffects.clear();
+    ownedTriggers.clear();
+    ownedIdTable.clear();
+    ownedStrings.clear();
+    removedNodes.clear();
+    mapped = false;
+    finalized = false;
+    reopened = false;
+    bindOwned();
+}
+
+// ---------------- Building ----------------
+
+uint32_t NodeStore::appendString(std::string_view s) {
+    return ownedStrings.intern(s);
+}
+
+uint32_t NodeStore::stagingIndex(int id) {
+    if (finalized || mapped) reopen();
+    auto it = buildIndex.find(id);
+    return it != buildIndex.end() ? it->second : NO_INDEX;
+}
+
+void NodeStore::addNode(int id, std::string_view text, bool isEnding) {
+    uint32_t index = stagingIndex(id);
+
+    NodeRecord rec = {};
+    rec.id = id;
+    rec.flags = isEnding ? NODE_ENDING : 0;
+    rec.textOffset = appendString(text);
+    rec.textLength = static_cast<uint32_t>(text.size());
+
+    // Redefinition replaces the node; the old record and its choices and
+    // triggers are dropped by finalize()
+    if (index != NO_INDEX) removedNodes.push_back(index);
+    buildIndex[id] = static_cast<uint32_t>(ownedNodes.size());
+    ownedNodes.push_back(rec);
+}
+
+bool NodeStore::addChoice(int nodeId, std::string_view text, int targetNodeId, const std::vector<StatEffect>& effectList) {
+    uint32_t owner = stagingIndex(nodeId);
+    if (owner == NO_INDEX) {
+        unknownNodeRefs.push_back(nodeId);
+        return false;
+    }
+
+    StagedChoice staged;
+    staged.owner = owner;
+    staged.record.textOffset = appendString(text);
+    staged.record.textLength = static_cast<uint32_t>(text.size());
+    staged.record.targetNodeId = targetNodeId;
+    staged.record.targetIndex = NO_INDEX;
+    staged.record.firstEffect = static_cast<uint32_t>(ownedEffects.size());
+    staged.record.effectCount = static_cast<uint32_t>(effectList.size());
+    StatEffect folded;
+    for (const StatEffect& e : effectList) {
+        ownedEffects.push_back(toEffectRecord(e));
+        folded += e;
+    }
+
+    // A lone effect is its own sum; several get a folded record after them
+    if (effectList.empty()) {
+        staged.record.foldedEffect = NO_INDEX;
+    } else if (effectList.size() == 1) {
+        staged.record.foldedEffect = staged.record.firstEffect;
+    } else {
+        staged.record.foldedEffect = static_cast<uint32_t>(ownedEffects.size());
+        ownedEffects.push_back(toEffectRecord(folded));
+    }
+    stagedChoices.push_back(staged);
+    return true;
+}
+
+bool NodeStore::addTrigger(int nodeId, int eventId) {
+    uint32_t owner = stagingIndex(nodeId);
+    if (owner == NO_INDEX) {
+        unknownNodeRefs.push_back(nodeId);
+        return false;
+    }
+
+    stagedTriggers.push_back({owner, eventId});
+    return true;
+}
+
+bool NodeStore::setEndingType(int nodeId, std::string_view type) {
+    uint32_t index = stagingIndex(nodeId);
+    if (index == NO_INDEX) {
+        unknownNodeRefs.push_back(nodeId);
+        return false;
+    }
+
+    ownedNodes[index].endingOffset = appendString(type);
+    ownedNodes[index].endingLength = static_cast<uint32_t>(type.size());
+    return true;
+}
+
+// The node only leaves the staging index here; finalize() drops all
+// removed nodes in one pass, so a batch of removals costs O(N) in total
+bool NodeStore::removeNode(int id) {
+    uint32_t index = stagingIndex(id);
+    if (index == NO_INDEX) return false;
+
+    removedNodes.push_back(index);
+    buildIndex.erase(id);
+    return true;
+}
+
+void NodeStore::edit() {
+    if (finalized || mapped) reopen();
+}
+
+// Turns packed (or mapped) tables back into staging form so building can continue
+void NodeStore::reopen() {
+    if (mapped) {
+        std::vector<NodeRecord> n(nodes, nodes + nodeCount);
+        std::vector<ChoiceRecord> c(choices, choices + choiceCount);
+        std::vector<EffectRecord> e(effects, effects + effectCount);
+        std::vector<int32_t> t(triggers, triggers + triggerCount);
+        ownedStrings.adopt(std::string(strings, stringSize));
+        ownedNodes.swap(n);
+        ownedChoices.swap(c);
+        ownedEffects.swap(e);
+        ownedTriggers.swap(t);
+        mapped = false;
+    }
+
+    buildIndex.clear();
+    stagedChoices.clear();
+    stagedTriggers.clear();
+    size_t dangling = 0;
+    for (uint32_t i = 0; i < ownedNodes.size(); ++i) {
+        NodeRecord& rec = ownedNodes[i];
+        buildIndex.emplace(rec.id, i);
+
+        // Merge dangling choices back in at their authored positions
+        uint32_t packed = 0;
+        for (uint32_t slot = 0; ; ++slot) {
+            if (dangling < danglingChoices.size() && danglingChoices[dangling].owner == i &&
+                danglingChoices[dangling].slot == slot) {
+                stagedChoices.push_back({i, danglingChoices[dangling++].record});
+            } else if (packed < rec.choiceCount) {
+                stagedChoices.push_back({i, ownedChoices[rec.firstChoice + packed++]});
+            } else {
+                break;
+            }
+        }
+        for (uint32_t t = 0; t < rec.triggerCount; ++t) {
+            stagedTriggers.push_back({i, ownedTriggers[rec.firstTrigger + t]});
+        }
+        rec.firstChoice = rec.choiceCount = rec.firstTrigger = rec.triggerCount = 0;
+    }
+    danglingChoices.clear();
+    ownedChoices.clear();
+    ownedTriggers.clear();
+    ownedIdTable.clear();
+    finalized = false;
+    reopened = true;
+}
+
+// Drops removed and replaced nodes with their staged choices and
+// triggers, renumbering the owners of the rest
+void NodeStore::dropRemoved() {
+    if (removedNodes.empty()) return;
+
+    std::vector<uint32_t> remap(ownedNodes.size(), 0);
+    for (uint32_t index : removedNodes) remap[index] = NO_INDEX;
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < ownedNodes.size(); ++i) {
+        if (remap[i] == NO_INDEX) continue;
+        remap[i] = kept;
+        ownedNodes[kept++] = ownedNodes[i];
+    }
+    ownedNodes.resize(kept);
+
+    size_t out = 0;
+    for (const StagedChoice& c : stagedChoices) {
+        if (remap[c.owner] != NO_INDEX) stagedChoices[out++] = {remap[c.owner], c.record};
+    }
+    stagedChoices.resize(out);
+    out = 0;
+    for (const StagedTrigger& t : stagedTriggers) {
+        if (remap[t.owner] != NO_INDEX) stagedTriggers[out++] = {remap[t.owner], t.eventId};
+    }
+    stagedTriggers.resize(out);
+    removedNodes.clear();
+}
+
+// Rebuilds the effect table and string arena from the records still in
+// use. Edits append their text and effects, so after a reopen the old
+// versions would otherwise stay in the tables for the whole session.
+void NodeStore::compact() {
+    std::vector<EffectRecord> liveEffects;
+    StringPool liveStrings;
+
+    auto keepText = [&](uint32_t& offset, uint32_t length) {
+        offset = liveStrings.intern(ownedStrings.get(offset, length));
+    };
+    auto keepChoice = [&](ChoiceRecord& c) {
+        keepText(c.textOffset, c.textLength);
+        const uint32_t first = static_cast<uint32_t>(liveEffects.size());
+        liveEffects.insert(liveEffects.end(), ownedEffects.begin() + c.firstEffect,
+                           ownedEffects.begin() + c.firstEffect + c.effectCount);
+        if (c.effectCount > 1) {
+            liveEffects.push_back(ownedEffects[c.foldedEffect]);
+            c.foldedEffect = first + c.effectCount;
+        } else if (c.effectCount == 1) {
+            c.foldedEffect = first;
+        }
+        c.firstEffect = first;
+    };
+
+    for (NodeRecord& rec : ownedNodes) {
+        keepText(rec.textOffset, rec.textLength);
+        keepText(rec.endingOffset, rec.endingLength);
+    }
+    for (ChoiceRecord& c : ownedChoices) keepChoice(c);
+    for (DanglingChoice& d : danglingChoices) keepChoice(d.record);
+
+    ownedEffects.swap(liveEffects);
+    std::swap(ownedStrings, liveStrings);
+    reopened = false;
+}
+
+void NodeStore::finalize() {
+    if (finalized || mapped) return;
+    dropRemoved();
+
+    const uint32_t count = static_cast<uint32_t>(ownedNodes.size());
+
+    // Order nodes by id (already the case for hand-written stories)
+    std::vector<uint32_t> newIndex(count);
+    bool sorted = true;
+    for (uint32_t i = 1; i < count && sorted; ++i) {
+        sorted = ownedNodes[i - 1].id < ownedNodes[i].id;
+    }
+    if (sorted) {
+        for (uint32_t i = 0; i < count; ++i) newIndex[i] = i;
+    } else {
+        std::vector<uint32_t> order(count);
+        for (uint32_t i = 0; i < count; ++i) order[i] = i;
+        std::sort(order.begin(), order.end(),
+                  [this](uint32_t a, uint32_t b) { return ownedNodes[a].id < ownedNodes[b].id; });
+        std::vector<NodeRecord> sortedNodes(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            sortedNodes[i] = ownedNodes[order[i]];
+            newIndex[order[i]] = i;
+        }
+        ownedNodes.swap(sortedNodes);
+    }
+
+    // Counting sort of choices and triggers by owning node (stable)
+    for (NodeRecord& rec : ownedNodes) {
+        rec.choiceCount = rec.triggerCount = 0;
+    }
+    for (const StagedChoice& c : stagedChoices) ownedNodes[newIndex[c.owner]].choiceCount++;
+    for (const StagedTrigger& t : stagedTriggers) ownedNodes[newIndex[t.owner]].triggerCount++;
+
+    uint32_t choiceCursor = 0, triggerCursor = 0;
+    for (NodeRecord& rec : ownedNodes) {
+        rec.firstChoice = choiceCursor;
+        rec.firstTrigger = triggerCursor;
+        choiceCursor += rec.choiceCount;
+        triggerCursor += rec.triggerCount;
+    }
+
+    ownedChoices.resize(stagedChoices.size());
+    ownedTriggers.resize(stagedTriggers.size());
+    std::vector<uint32_t> fill(count, 0);
+    for (const StagedChoice& c : stagedChoices) {
+        uint32_t owner = newIndex[c.owner];
+        ownedChoices[ownedNodes[owner].firstChoice + fill[owner]++] = c.record;
+    }
+    std::fill(fill.begin(), fill.end(), 0);
+    for (const StagedTrigger& t : stagedTriggers) {
+        uint32_t owner = newIndex[t.owner];
+        ownedTriggers[ownedNodes[owner].firstTrigger + fill[owner]++] = t.eventId;
+    }
+
+    // Direct id table when IDs are reasonably dense
+    ownedIdTable.clear();
+    idBase = 0;
+    if (count > 0) {
+        int64_t range = static_cast<int64_t>(ownedNodes.back().id) - ownedNodes.front().id + 1;
+        if (range <= 2 * static_cast<int64_t>(count) + 64) {
+            idBase = ownedNodes.front().id;
+            ownedIdTable.assign(static_cast<size_t>(range), NO_INDEX);
+            for (uint32_t i = 0; i < count; ++i) {
+                ownedIdTable[static_cast<size_t>(ownedNodes[i].id - idBase)] = i;
+            }
+        }
+    }
+
+    buildIndex.clear();
+    stagedChoices.clear();
+    stagedChoices.shrink_to_fit();
+    stagedTriggers.clear();
+    stagedTriggers.shrink_to_fit();
+
+    finalized = true;
+    bindOwned();
+
+    // Resolve choice targets to dense indices, setting aside (in order)
+    // choices whose target does not exist
+    uint32_t kept = 0;
+    for (uint32_t n = 0; n < count; ++n) {
+        NodeRecord& rec = ownedNodes[n];
+        const uint32_t first = rec.firstChoice;
+        rec.firstChoice = kept;
+        for (uint32_t slot = 0; slot < rec.choiceCount; ++slot) {
+            ChoiceRecord c = ownedChoices[first + slot];
+            c.targetIndex = findIndex(c.targetNodeId);
+            if (c.targetIndex == NO_INDEX) danglingChoices.push_back({n, slot, c});
+            else ownedChoices[kept++] = c;
+        }
+        rec.choiceCount = kept - rec.firstChoice;
+    }
+    ownedChoices.resize(kept);
+    if (reopened) compact();
+    bindOwned();
+}
+
+bool NodeStore::isFinalized() const {
+    return finalized || mapped;
+}
+
+const std::vector<DanglingChoice>& NodeStore::getDanglingChoices() const {
+    return danglingChoices;
+}
+
+const std::vector<int>& NodeStore::getUnknownNodeRefs() const {
+    return unknownNodeRefs;
+}
+
+void NodeStore::bindOwned() {
+    nodes = ownedNodes.data();
+    choices = ownedChoices.data();
+    effects = ownedEffects.data();
+    triggers = ownedTriggers.data();
+    idTable = ownedIdTable.data();
+    strings = ownedStrings.data();
+    nodeCount = static_cast<uint32_t>(ownedNodes.size());
+    choiceCount = static_cast<uint32_t>(ownedChoices.size());
+    effectCount = static_cast<uint32_t>(ownedEffects.size());
+    triggerCount = static_cast<uint32_t>(ownedTriggers.size());
+    idTableSize = static_cast<uint32_t>(ownedIdTable.size());
+    stringSize = ownedStrings.size();
+}
+
+void NodeStore::bind(const StoryImage& image) {
+    clear();
+
+    const Header& h = image.getHeader();
+    nodes = image.getNodes();
+    choices = image.getChoices();
+    effects = image.getEffects();
+    triggers = image.getTriggers();
+    idTable = image.getIdTable();
+    strings = image.getStrings();
+    nodeCount = h.nodeCount;
+    choiceCount = h.choiceCount;
+    effectCount = h.effectCount;
+    triggerCount = h.triggerCount;
+    idBase = h.idBase;
+    idTableSize = h.idTableSize;
+    stringSize = static_cast<size_t>(h.stringSize);
+    mapped = true;
+}
+
+void NodeStore::bind(const NodeStore& source) {
+    clear();
+    if (!source.isFinalized()) return;
+
+    nodes = source.nodes;
+    choices = source.choices;
+    effects = source.effects;
+    triggers = source.triggers;
+    idTable = source.idTable;
+    strings = source.strings;
+    nodeCount = source.nodeCount;
+    choiceCount = source.choiceCount;
+    effectCount = source.effectCount;
+    triggerCount = source.triggerCount;
+    idBase = source.idBase;
+    idTableSize = source.idTableSize;
+    stringSize = source.stringSize;
+    mapped = true;
+}
+
+// ---------------- Lookup ----------------
+
+uint32_t NodeStore::findIndex(int id) const {
+    if (!isFinalized()) return NO_INDEX;
+
+    if (idTableSize > 0) {
+        int64_t slot = static_cast<int64_t>(id) - idBase;
+        if (slot < 0 || slot >= idTableSize) return NO_INDEX;
+        const uint32_t index = idTable[slot];
+        return (index < nodeCount && nodes[index].id == id) ? index : NO_INDEX;   // mapped tables are unchecked
+    }
+
+    uint32_t lo = 0, hi = nodeCount;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (nodes[mid].id < id) lo = mid + 1;
+        else hi = mid;
+    }
+    return (lo < nodeCount && nodes[lo].id == id) ? lo : NO_INDEX;
+}
+
+uint32_t NodeStore::getNodeCount() const { return isFinalized() ? nodeCount : 0; }
+uint32_t NodeStore::getChoiceCount() const { return choiceCount; }
+uint32_t NodeStore::getEffectCount() const { return effectCount; }
+uint32_t NodeStore::getTriggerCount() const { return triggerCount; }
+
+const NodeRecord& NodeStore::getNode(uint32_t index) const { return nodes[index]; }
+const ChoiceRecord& NodeStore::getChoice(uint32_t index) const { return choices[index]; }
+const EffectRecord* NodeStore::getEffects() const { return effects; }
+const int32_t* NodeStore::getTriggers() const { return triggers; }
+const char* NodeStore::getStrings() const { return strings; }
+size_t NodeStore::getStringSize() const { return stringSize; }
+
+std::string_view NodeStore::getString(uint32_t offset, uint32_t length) const {
+    return std::string_view(strings + offset, length);
+}
+
+size_t NodeStore::getMemoryUsage() const {
+    return nodeCount * sizeof(NodeRecord) + choiceCount * sizeof(ChoiceRecord) +
+           effectCount * sizeof(EffectRecord) + triggerCount * sizeof(int32_t) +
+           idTableSize * sizeof(uint32_t) + stringSize;
+}
+
+bool NodeStore::writeImage(const std::string& filename) const {
+    if (!isFinalized()) return false;
+
+    std::vector<NodeRecord> n(nodes, nodes + nodeCount);
+    std::vector<ChoiceRecord> c(choices, choices + choiceCount);
+    std::vector<EffectRecord> e(effects, effects + effectCount);
+    std::vector<int32_t> t(triggers, triggers + triggerCount);
+    return StoryImage::write(filename, n, c, e, t, std::string(strings, stringSize));
+}
@@ -0,0 +1,291 @@
+#include "PlaythroughAnalyzer.h"
+#include "GameSession.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+// ============================================================
+// StatHistogram Implementation
+// ============================================================
+
+void StatHistogram::add(int value) {
+    int bucket = value < 0 ? 0 : (value >= BUCKETS ? BUCKETS - 1 : value);
+    counts[bucket]++;
+    sum += static_cast<uint64_t>(value < 0 ? 0 : value);
+    if (value < minValue) minValue = value;
+    if (value > maxValue) maxValue = value;
+}
+
+void StatHistogram::merge(const StatHistogram& other) {
+    for (int i = 0; i < BUCKETS; ++i) counts[i] += other.counts[i];
+    sum += other.sum;
+    if (other.minValue < minValue) minValue = other.minValue;
+    if (other.maxValue > maxValue) maxValue = other.maxValue;
+}
+
+double StatHistogram::mean(uint64_t samples) const {
+    return samples ? static_cast<double>(sum) / samples : 0.0;
+}
+
+int StatHistogram::percentile(double p) const {
+    uint64_t total = 0;
+    for (int i = 0; i < BUCKETS; ++i) total += counts[i];
+    if (total == 0) return 0;
+
+    uint64_t target = static_cast<uint64_t>(p * (total - 1));
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKETS; ++i) {
+        seen += counts[i];
+        if (seen > target) return i;
+    }
+    return BUCKETS - 1;
+}
+
+namespace {
+
+// ---------------- Per-playthrough RNG ----------------
+
+uint64_t splitmix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+// xorshift64*, seeded from (seed, playthrough index)
+class PlayRng {
+public:
+    PlayRng(uint64_t seed, uint64_t index) : s(splitmix64(seed ^ splitmix64(index)) | 1) {}
+
+    uint32_t next() {
+        s ^= s >> 12;
+        s ^= s << 25;
+        s ^= s >> 27;
+        return static_cast<uint32_t>((s * 0x2545F4914F6CDD1Dull) >> 32);
+    }
+
+    // Uniform in [0, n)
+    uint32_t below(uint32_t n) {
+        return static_cast<uint32_t>((static_cast<uint64_t>(next()) * n) >> 32);
+    }
+
+private:
+    uint64_t s;
+};
+
+// ---------------- Work-stealing scheduler ----------------
+
+// Chunk range [begin, end) owned by one worker, packed into one word so
+// the owner (taking from the front) and thieves (taking the back half)
+// can both claim work with a single CAS.
+struct alignas(64) WorkRange {
+    std::atomic<uint64_t> range{0};
+};
+
+uint64_t packRange(uint32_t begin, uint32_t end) {
+    return (static_cast<uint64_t>(end) << 32) | begin;
+}
+
+bool popFront(WorkRange& work, uint32_t& chunk) {
+    uint64_t current = work.range.load(std::memory_order_acquire);
+    for (;;) {
+        uint32_t begin = static_cast<uint32_t>(current);
+        uint32_t end = static_cast<uint32_t>(current >> 32);
+        if (begin >= end) return false;
+        if (work.range.compare_exchange_weak(current, packRange(begin + 1, end),
+                                             std::memory_order_acq_rel)) {
+            chunk = begin;
+            return true;
+        }
+    }
+}
+
+bool stealHalf(WorkRange& victim, uint32_t& stolenBegin, uint32_t& stolenEnd) {
+    uint64_t current = victim.range.load(std::memory_order_acquire);
+    for (;;) {
+        uint32_t begin = static_cast<uint32_t>(current);
+        uint32_t end = static_cast<uint32_t>(current >> 32);
+        if (begin >= end) return false;
+        uint32_t mid = begin + (end - begin) / 2;
+        if (victim.range.compare_exchange_weak(current, packRange(begin, mid),
+                                               std::memory_order_acq_rel)) {
+            stolenBegin = mid;
+            stolenEnd = end;
+            return true;
+        }
+    }
+}
+
+struct alignas(64) WorkerResult {
+    AnalyzerReport report;
+};
+
+// ---------------- Simulation ----------------
+
+class Worker {
+public:
+    Worker(const DecisionTree& story, const AnalyzerConfig& config, AnalyzerReport& report)
+        : config(config), report(report), session(tree, sessionOptions()) {
+        tree.attachStory(story);
+        report.endingCounts.assign(tree.getNodeCount(), 0);
+    }
+
+    void runChunk(uint32_t chunk) {
+        uint64_t first = static_cast<uint64_t>(chunk) * config.chunkSize;
+        uint64_t last = first + config.chunkSize;
+        if (last > config.playthroughs) last = config.playthroughs;
+        for (uint64_t i = first; i < last; ++i) play(i);
+    }
+
+private:
+    DecisionTree tree;
+    const AnalyzerConfig& config;
+    AnalyzerReport& report;
+    GameSession session;
+
+    static SessionOptions sessionOptions() {
+        SessionOptions options;
+        options.trackHistory = false;
+        options.keepEventLog = false;
+        options.keepStatHistory = false;
+        options.verbose = false;
+        options.seed = 1;
+        return options;
+    }
+
+    int pickChoice(PlayRng& rng, int step, uint32_t choiceCount) const {
+        switch (config.policy) {
+            case PlayPolicy::FirstChoice:
+                return 0;
+            case PlayPolicy::Scripted:
+                if (step < static_cast<int>(config.script.size()) &&
+                    config.script[step] < static_cast<int>(choiceCount)) {
+                    return config.script[step];
+                }
+                return static_cast<int>(rng.below(choiceCount));
+            case PlayPolicy::Random:
+            default:
+                return static_cast<int>(rng.below(choiceCount));
+        }
+    }
+
+    void play(uint64_t index) {
+        PlayRng rng(config.seed, index);
+        session.restart();
+
+        int steps = 0;
+        while (!session.isOver() && steps < config.maxSteps) {
+            uint32_t choiceCount = static_cast<uint32_t>(tree.getCurrentNode().getChoicesWithEffects().size());
+            if (choiceCount == 0) break;
+
+            int choice = pickChoice(rng, steps, choiceCount);
+            session.resolveChoice(choice, 1 + static_cast<int>(rng.below(100)));
+            session.drainEvents();
+            ++steps;
+        }
+
+        const GameState& state = session.getState();
+        Node node = tree.getCurrentNode();
+        if (node.isValid() && node.isEndingNode()) report.endingCounts[node.getIndex()]++;
+        else if (state.stats.isDead()) report.deaths++;
+        else report.stalled++;
+
+        report.playthroughs++;
+        report.totalDays += static_cast<uint64_t>(state.day);
+        if (state.day > report.maxDays) report.maxDays = state.day;
+
+        report.stats[AnalyzerReport::HEALTH].add(state.stats.getHealth());
+        report.stats[AnalyzerReport::HUNGER].add(state.stats.getHunger());
+        report.stats[AnalyzerReport::STAMINA].add(state.stats.getStamina());
+        report.stats[AnalyzerReport::PACK_STATUS].add(state.stats.getPackStatus());
+        report.stats[AnalyzerReport::MORALE].add(state.stats.getMorale());
+        report.stats[AnalyzerReport::STRENGTH].add(state.stats.getStrength());
+        report.stats[AnalyzerReport::XP].add(state.stats.getXP());
+    }
+};
+
+void mergeInto(AnalyzerReport& total, const AnalyzerReport& part) {
+    total.playthroughs += part.playthroughs;
+    total.deaths += part.deaths;
+    total.stalled += part.stalled;
+    total.totalDays += part.totalDays;
+    if (part.maxDays > total.maxDays) total.maxDays = part.maxDays;
+    if (total.endingCounts.size() < part.endingCounts.size()) {
+        total.endingCounts.resize(part.endingCounts.size(), 0);
+    }
+    for (size_t i = 0; i < part.endingCounts.size(); ++i) {
+        total.endingCounts[i] += part.endingCounts[i];
+    }
+    for (int s = 0; s < AnalyzerReport::STAT_COUNT; ++s) {
+        total.stats[s].merge(part.stats[s]);
+    }
+}
+
+}
+
+namespace PlaythroughAnalyzer {
+
+AnalyzerReport run(const DecisionTree& story, const AnalyzerConfig& userConfig) {
+    AnalyzerConfig config = userConfig;
+    if (config.chunkSize == 0) config.chunkSize = 1;
+
+    unsigned int threads = config.threads;
+    if (threads == 0) threads = std::thread::hardware_concurrency();
+    if (threads == 0) threads = 1;
+
+    const uint64_t chunkCount = (config.playthroughs + config.chunkSize - 1) / config.chunkSize;
+    if (chunkCount > UINT32_MAX) {
+        config.chunkSize = static_cast<uint32_t>((config.playthroughs + UINT32_MAX - 1) / UINT32_MAX);
+    }
+    const uint32_t chunks = static_cast<uint32_t>((config.playthroughs + config.chunkSize - 1) / config.chunkSize);
+    if (threads > chunks && chunks > 0) threads = chunks;
+
+    // Initial even split; stealing rebalances from there
+    std::vector<WorkRange> ranges(threads);
+    for (unsigned int t = 0; t < threads; ++t) {
+        uint32_t begin = static_cast<uint32_t>(static_cast<uint64_t>(chunks) * t / threads);
+        uint32_t end = static_cast<uint32_t>(static_cast<uint64_t>(chunks) * (t + 1) / threads);
+        ranges[t].range.store(packRange(begin, end), std::memory_order_relaxed);
+    }
+
+    std::vector<WorkerResult> results(threads);
+    auto start = std::chrono::steady_clock::now();
+
+    auto workerMain = [&](unsigned int id) {
+        Worker worker(story, config, results[id].report);
+        WorkRange& own = ranges[id];
+
+        for (;;) {
+            uint32_t chunk;
+            if (popFront(own, chunk)) {
+                worker.runChunk(chunk);
+                continue;
+            }
+
+            bool stolen = false;
+            for (unsigned int k = 1; k < threads && !stolen; ++k) {
+                uint32_t begin, end;
+                if (stealHalf(ranges[(id + k) % threads], begin, end)) {
+                    own.range.store(packRange(begin + 1, end), std::memory_order_release);
+                    worker.runChunk(begin);
+                    stolen = true;
+                }
+            }
+            if (!stolen) break;
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned int t = 1; t < threads; ++t) pool.emplace_back(workerMain, t);
+    workerMain(0);
+    for (std::thread& thread : pool) thread.join();
+
+    AnalyzerReport total;
+    total.endingCounts.assign(story.getNodeCount(), 0);
+    for (const WorkerResult& result : results) mergeInto(total, result.report);
+    total.threads = threads;
+    total.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return total;
+}
+
+}
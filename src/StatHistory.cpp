@@ -0,0 +1,218 @@
+#include "StatHistory.h"
+#include <cstdio>
+
+// ============================================================
+// StatSeries Implementation
+// ============================================================
+
+namespace {
+    using Bucket = StatSeries::Bucket;
+
+    const char* const NAMES[STAT_COUNT] = { "health", "hunger", "stamina", "packStatus", "morale", "strength", "xp" };
+
+    void merge(Bucket& into, const Bucket& from) {
+        if (from.count == 0) return;
+        if (into.count == 0) {
+            into = from;
+            return;
+        }
+        for (int s = 0; s < STAT_COUNT; ++s) {
+            if (from.min[s] < into.min[s]) into.min[s] = from.min[s];
+            if (from.max[s] > into.max[s]) into.max[s] = from.max[s];
+            into.sum[s] += from.sum[s];
+        }
+        into.count += from.count;
+        if (from.first < into.first) into.first = from.first;
+    }
+}
+
+StatSeries::StatSeries() : rings(static_cast<size_t>(LEVELS) * CAPACITY) {
+    clear();
+}
+
+// ---------------- Recording ----------------
+
+void StatSeries::record(const Stats& stats) {
+    Bucket sample;
+    for (int s = 0; s < STAT_COUNT; ++s) {
+        const int value = stats.getStat(static_cast<StatId>(s));
+        sample.min[s] = value;
+        sample.max[s] = value;
+        sample.sum[s] = value;
+    }
+    sample.count = 1;
+    sample.first = samples++;
+    push(0, sample);
+}
+
+// Store a completed bucket and roll it up into the level above
+void StatSeries::push(int level, const Bucket& bucket) {
+    rings[static_cast<size_t>(level) * CAPACITY + head[level]] = bucket;
+    head[level] = (head[level] + 1) % CAPACITY;
+    if (size[level] < CAPACITY) ++size[level];
+
+    const int up = level + 1;
+    if (up == LEVELS) return;
+    merge(partial[up], bucket);
+    if (++merged[up] == FACTOR) {
+        const Bucket done = partial[up];
+        partial[up].count = 0;
+        merged[up] = 0;
+        push(up, done);
+    }
+}
+
+uint64_t StatSeries::getSampleCount() const {
+    return samples;
+}
+
+void StatSeries::clear() {
+    for (int level = 0; level < LEVELS; ++level) {
+        head[level] = 0;
+        size[level] = 0;
+        partial[level].count = 0;
+        merged[level] = 0;
+    }
+    samples = 0;
+}
+
+// ---------------- Reading ----------------
+
+// Finest level whose ring has not wrapped, i.e. still reaches back to
+// the first sample; the top level once every ring has
+int StatSeries::coveringLevel() const {
+    uint64_t span = 1;
+    for (int level = 0; level < LEVELS - 1; ++level, span *= FACTOR) {
+        if (samples / span <= static_cast<uint64_t>(CAPACITY)) return level;
+    }
+    return LEVELS - 1;
+}
+
+int StatSeries::plot(StatId stat, float* avg, float* min, float* max) const {
+    const int s = static_cast<int>(stat);
+    const int level = coveringLevel();
+
+    int points = 0;
+    auto emit = [&](const Bucket& b) {
+        avg[points] = static_cast<float>(b.sum[s]) / static_cast<float>(b.count);
+        min[points] = static_cast<float>(b.min[s]);
+        max[points] = static_cast<float>(b.max[s]);
+        ++points;
+    };
+    for (int i = 0; i < size[level]; ++i) emit(getBucket(level, i));
+
+    // Samples not yet rolled up to this level, as one trailing point
+    Bucket recent;
+    recent.count = 0;
+    for (int l = level; l > 0; --l) merge(recent, partial[l]);
+    if (recent.count > 0) emit(recent);
+    return points;
+}
+
+int StatSeries::getBucketCount(int level) const {
+    return size[level];
+}
+
+const StatSeries::Bucket& StatSeries::getBucket(int level, int index) const {
+    const int slot = (head[level] - size[level] + index + CAPACITY) % CAPACITY;
+    return rings[static_cast<size_t>(level) * CAPACITY + slot];
+}
+
+// ---------------- Files ----------------
+
+bool StatSeries::exportCsv(const std::string& path, std::string& error) const {
+    std::FILE* out = std::fopen(path.c_str(), "w");
+    if (!out) {
+        error = "cannot create " + path;
+        return false;
+    }
+
+    std::fprintf(out, "level,first,count");
+    for (const char* name : NAMES) std::fprintf(out, ",%s_min,%s_avg,%s_max", name, name, name);
+    std::fprintf(out, "\n");
+
+    for (int level = LEVELS - 1; level >= 0; --level) {
+        for (int i = 0; i < size[level]; ++i) {
+            const Bucket& b = getBucket(level, i);
+            std::fprintf(out, "%d,%llu,%u", level, static_cast<unsigned long long>(b.first), b.count);
+            for (int s = 0; s < STAT_COUNT; ++s) {
+                std::fprintf(out, ",%d,%.2f,%d", b.min[s],
+                             static_cast<double>(b.sum[s]) / static_cast<double>(b.count), b.max[s]);
+            }
+            std::fprintf(out, "\n");
+        }
+    }
+
+    const bool ok = !std::ferror(out);
+    if (std::fclose(out) != 0 || !ok) {
+        error = "cannot write " + path;
+        return false;
+    }
+    return true;
+}
+
+bool StatSeries::exportBinary(const std::string& path, std::string& error) const {
+    std::FILE* out = std::fopen(path.c_str(), "wb");
+    if (!out) {
+        error = "cannot create " + path;
+        return false;
+    }
+
+    Header header;
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.levels = LEVELS;
+    header.factor = FACTOR;
+    header.capacity = CAPACITY;
+    header.statCount = STAT_COUNT;
+    header.samples = samples;
+
+    bool ok = std::fwrite(&header, sizeof(header), 1, out) == 1;
+    for (int level = 0; ok && level < LEVELS; ++level) {
+        const uint32_t count = static_cast<uint32_t>(size[level]);
+        ok = std::fwrite(&count, sizeof(count), 1, out) == 1;
+        for (int i = 0; ok && i < size[level]; ++i) {
+            ok = std::fwrite(&getBucket(level, i), sizeof(Bucket), 1, out) == 1;
+        }
+    }
+    if (std::fclose(out) != 0 || !ok) {
+        error = "cannot write " + path;
+        return false;
+    }
+    return true;
+}
+
+// Partial buckets are not saved; a loaded series is for reading
+bool StatSeries::load(const std::string& path, std::string& error) {
+    std::FILE* in = std::fopen(path.c_str(), "rb");
+    if (!in) {
+        error = "cannot open " + path;
+        return false;
+    }
+
+    Header header;
+    bool ok = false;
+    if (std::fread(&header, sizeof(header), 1, in) != 1 || header.magic != MAGIC) {
+        error = "not a stat history";
+    } else if (header.version != VERSION || header.levels != LEVELS || header.factor != FACTOR ||
+               header.capacity != CAPACITY || header.statCount != STAT_COUNT) {
+        error = "unsupported stat history layout";
+    } else {
+        clear();
+        ok = true;
+        for (int level = 0; ok && level < LEVELS; ++level) {
+            uint32_t count = 0;
+            ok = std::fread(&count, sizeof(count), 1, in) == 1 && count <= static_cast<uint32_t>(CAPACITY) &&
+                 std::fread(&rings[static_cast<size_t>(level) * CAPACITY], sizeof(Bucket), count, in) == count;
+            size[level] = static_cast<int>(count);
+            head[level] = static_cast<int>(count) % CAPACITY;
+        }
+        samples = header.samples;
+        if (!ok) {
+            clear();
+            error = "truncated stat history";
+        }
+    }
+    std::fclose(in);
+    return ok;
+}
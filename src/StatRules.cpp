@@ -0,0 +1,91 @@
+#include "StatRules.h"
+
+// ============================================================
+// StatRuleSet Implementation
+// ============================================================
+
+StatRuleSet::StatRuleSet() : compiled(true) {}
+
+void StatRuleSet::add(const StatRule& rule) {
+    rules.push_back(rule);
+    compiled = false;
+}
+
+void StatRuleSet::compile() {
+    const size_t count = rules.size();
+    column.resize(count);
+    sign.resize(count);
+    fireLevel.resize(count);
+    rearmLevel.resize(count);
+
+    for (size_t r = 0; r < count; ++r) {
+        const StatRule& rule = rules[r];
+        int hysteresis = rule.hysteresis < 0 ? 0 : rule.hysteresis;
+
+        // Above t becomes -value < -t, so both comparators share one test
+        column[r] = static_cast<uint8_t>(rule.stat);
+        sign[r] = rule.comparator == Comparator::Below ? 1 : -1;
+        fireLevel[r] = sign[r] * rule.threshold;
+        rearmLevel[r] = fireLevel[r] + hysteresis;
+    }
+    compiled = true;
+}
+
+void StatRuleSet::clear() {
+    rules.clear();
+    compile();
+}
+
+size_t StatRuleSet::size() const {
+    return rules.size();
+}
+
+const StatRule& StatRuleSet::getRule(size_t index) const {
+    return rules[index];
+}
+
+int StatRuleSet::getEventId(size_t index) const {
+    return rules[index].eventId;
+}
+
+size_t StatRuleSet::evaluate(const StatColumns& stats, uint8_t* armed, uint8_t* fired) const {
+    if (!compiled) return 0;
+
+    const size_t count = stats.count;
+    size_t total = 0;
+    for (size_t r = 0; r < rules.size(); ++r) {
+        const int* values = stats.values[column[r]];
+        const int s = sign[r];
+        const int fire = fireLevel[r];
+        const int rearm = rearmLevel[r];
+        uint8_t* a = armed + r * count;
+        uint8_t* f = fired + r * count;
+
+        // Plain element-wise loop the compiler can vectorize
+        size_t hits = 0;
+        for (size_t e = 0; e < count; ++e) {
+            const int x = s * values[e];
+            const uint8_t isArmed = a[e];
+            const uint8_t trip = isArmed & static_cast<uint8_t>(x < fire);
+            const uint8_t reset = static_cast<uint8_t>(isArmed ^ 1) & static_cast<uint8_t>(x >= rearm);
+            a[e] = static_cast<uint8_t>((isArmed & (trip ^ 1)) | reset);
+            f[e] = trip;
+            hits += trip;
+        }
+        total += hits;
+    }
+    return total;
+}
+
+void StatRuleSet::sync(const StatColumns& stats, uint8_t* armed) const {
+    if (!compiled) return;
+
+    const size_t count = stats.count;
+    for (size_t r = 0; r < rules.size(); ++r) {
+        const int* values = stats.values[column[r]];
+        uint8_t* a = armed + r * count;
+        for (size_t e = 0; e < count; ++e) {
+            a[e] = static_cast<uint8_t>(sign[r] * values[e] >= fireLevel[r]);
+        }
+    }
+}
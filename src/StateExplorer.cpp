@@ -0,0 +1,441 @@
+#include "StateExplorer.h"
+#include "GameSession.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+// ============================================================
+// PackedState Implementation
+// ============================================================
+
+static_assert(sizeof(PackedState) == 16, "event bits must fit the padding of a packed state");
+
+namespace {
+
+int statOf(const Stats& stats, int s) {
+    switch (s) {
+        case 0: return stats.getHealth();
+        case 1: return stats.getHunger();
+        case 2: return stats.getStamina();
+        case 3: return stats.getPackStatus();
+        case 4: return stats.getMorale();
+        case 5: return stats.getStrength();
+        default: return stats.getXP();
+    }
+}
+
+}
+
+PackedState PackedState::pack(uint32_t node, const Stats& stats, uint32_t inventoryMask, uint32_t events) {
+    PackedState state;
+    state.bits = 0;
+    for (int s = 0; s < STAT_COUNT; ++s) {
+        int value = statOf(stats, s);
+        if (value < 0) value = 0;
+        if (value > STAT_MAX) value = STAT_MAX;
+        state.bits |= static_cast<uint64_t>(value) << (s * STAT_BITS);
+    }
+    state.bits |= static_cast<uint64_t>(inventoryMask & ((1u << INVENTORY_BITS) - 1)) << (STAT_COUNT * STAT_BITS);
+    state.node = node;
+    state.events = events;
+    return state;
+}
+
+int PackedState::stat(int s) const {
+    return static_cast<int>((bits >> (s * STAT_BITS)) & STAT_MAX);
+}
+
+uint32_t PackedState::inventoryMask() const {
+    return static_cast<uint32_t>(bits >> (STAT_COUNT * STAT_BITS));
+}
+
+Stats PackedState::unpackStats() const {
+    Stats stats;
+    stats.setHealth(stat(0));
+    stats.setHunger(stat(1));
+    stats.setStamina(stat(2));
+    stats.setPackStatus(stat(3));
+    stats.setMorale(stat(4));
+    stats.setStrength(stat(5));
+    stats.addXP(stat(6));
+    return stats;
+}
+
+// ============================================================
+// StateExplorer Implementation
+// ============================================================
+
+namespace {
+
+uint64_t hashState(const PackedState& state) {
+    const uint64_t tail = (static_cast<uint64_t>(state.node) << 32) | state.events;
+    uint64_t h = state.bits ^ (tail * 0x9E3779B97F4A7C15ull);
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    return h;
+}
+
+// Visited set: open addressing over indices into the state list
+class StateSet {
+public:
+    explicit StateSet(std::vector<PackedState>& states) : states(states), used(0) {
+        slots.assign(1024, StoryFormat::NO_INDEX);
+    }
+
+    // Appends the state to the list if it has not been seen before
+    bool insert(const PackedState& state) {
+        if ((used + 1) * 2 > slots.size()) grow();
+
+        size_t mask = slots.size() - 1;
+        size_t i = hashState(state) & mask;
+        while (slots[i] != StoryFormat::NO_INDEX) {
+            if (states[slots[i]] == state) return false;
+            i = (i + 1) & mask;
+        }
+        slots[i] = static_cast<uint32_t>(states.size());
+        states.push_back(state);
+        ++used;
+        return true;
+    }
+
+    size_t memoryUsage() const {
+        return slots.capacity() * sizeof(uint32_t);
+    }
+
+private:
+    std::vector<PackedState>& states;
+    std::vector<uint32_t> slots;
+    size_t used;
+
+    void grow() {
+        slots.assign(slots.size() * 2, StoryFormat::NO_INDEX);
+        size_t mask = slots.size() - 1;
+        for (uint32_t s = 0; s < states.size(); ++s) {
+            size_t i = hashState(states[s]) & mask;
+            while (slots[i] != StoryFormat::NO_INDEX) i = (i + 1) & mask;
+            slots[i] = s;
+        }
+    }
+};
+
+// Maps held items to mask bits, learning item kinds as they appear
+class ItemTable {
+public:
+    explicit ItemTable(ExplorerReport& report) : report(report) {}
+
+    uint32_t maskOf(const Inventory& inventory) {
+        uint32_t mask = 0;
+        for (InventoryNode* item = inventory.getHead(); item != nullptr; item = item->next) {
+            size_t bit = 0;
+            while (bit < kinds.size() && kinds[bit].name != item->name) ++bit;
+            if (bit == kinds.size()) {
+                if (bit == PackedState::INVENTORY_BITS) {
+                    report.truncated = true;
+                    continue;
+                }
+                kinds.push_back({item->name, item->type, item->effect});
+                report.items.push_back(item->name);
+            }
+            mask |= 1u << bit;
+        }
+        return mask;
+    }
+
+    void fill(Inventory& inventory, uint32_t mask) const {
+        inventory.clear();
+        for (size_t bit = 0; bit < kinds.size(); ++bit) {
+            if (mask & (1u << bit)) inventory.addItem(kinds[bit].name, kinds[bit].type, kinds[bit].effect, 1);
+        }
+    }
+
+private:
+    struct Kind {
+        std::string name;
+        std::string type;
+        int effect;
+    };
+    std::vector<Kind> kinds;
+    ExplorerReport& report;
+};
+
+// Maps the event state of a position to PackedState::events: one
+// armed flag per rule, then for each kind of follow-up timer one bit
+// per day ahead it can be due on (bit d: due in d + 1 days), then a
+// field per modifier kind on the player. A refreshed or stacking kind
+// has one instance, stored as 0 or (stacks - 1) * duration + days left;
+// an independent kind has one bit per days left. Timers and modifiers
+// are kept relative to the day, so the day counter stays out of the state.
+class EventBits {
+public:
+    EventBits(const EventManager& events, const ModifierPool& pool)
+        : rules(events.getRules().size()), used(rules) {
+        for (const EventManager::FollowUp& f : events.getFollowUps()) {
+            const uint32_t reach = std::max<uint32_t>(std::max(f.delayDays, f.periodDays), 1);
+            Kind* kind = find(f.followUpId, f.periodDays);
+            if (kind) {
+                if (reach <= kind->width) continue;
+                used -= kind->width;
+                kind->width = reach;
+            } else {
+                kinds.push_back({ f.followUpId, f.periodDays, 0, reach });
+                kind = &kinds.back();
+            }
+            used += reach;
+        }
+        size_t shift = rules;
+        for (Kind& kind : kinds) {
+            kind.shift = static_cast<uint32_t>(shift);
+            shift += kind.width;
+        }
+        for (int k = 0; pool.findType(k); ++k) {
+            const ModifierType* type = pool.findType(k);
+            Field field{ type, 0, type->duration };
+            if (type->stacking != Stacking::Independent) {
+                uint32_t values = type->duration * (type->stacking == Stacking::Stack ? type->maxStacks : 1u);
+                field.width = 0;
+                while (values) {
+                    ++field.width;
+                    values >>= 1;
+                }
+            }
+            field.shift = static_cast<uint32_t>(shift);
+            shift += field.width;
+            used += field.width;
+            fields.push_back(field);
+        }
+    }
+
+    bool fits() const {
+        return used <= static_cast<size_t>(PackedState::EVENT_BITS);
+    }
+
+    size_t bitsNeeded() const {
+        return used;
+    }
+
+    // False if a timer or modifier has no bit: not a follow-up, two of a
+    // kind due on the same day, or a modifier on another target
+    bool pack(const DaySchedule& schedule, int day, uint32_t& bits) {
+        bits = 0;
+        for (size_t r = 0; r < rules && r < schedule.ruleArmed.size(); ++r) {
+            if (schedule.ruleArmed[r]) bits |= 1u << r;
+        }
+        bool exact = true;
+        for (const DayTimer& timer : schedule.timers) {
+            const Kind* kind = find(timer.eventId, timer.period);
+            const int ahead = timer.dueDay - day;
+            if (!kind || ahead < 1 || ahead > static_cast<int>(kind->width)) {
+                exact = false;
+                continue;
+            }
+            const uint32_t bit = 1u << (kind->shift + static_cast<uint32_t>(ahead - 1));
+            if (bits & bit) exact = false;
+            bits |= bit;
+        }
+        for (const DayModifier& modifier : schedule.modifiers) {
+            const int left = modifier.lastDay - day;
+            if (modifier.target != 0 || modifier.kind < 0 || modifier.kind >= static_cast<int>(fields.size()) ||
+                left < 1 || left > fields[modifier.kind].type->duration) {
+                exact = false;
+                continue;
+            }
+            const Field& field = fields[modifier.kind];
+            uint32_t value = static_cast<uint32_t>(left - 1);
+            if (field.type->stacking != Stacking::Independent) {
+                value = static_cast<uint32_t>((modifier.stacks - 1) * field.type->duration + left);
+            }
+            const uint32_t slot = field.type->stacking == Stacking::Independent ? 1u << value : value;
+            if (bits & (slot << field.shift)) exact = false;
+            bits |= slot << field.shift;
+        }
+        return exact;
+    }
+
+    void unpack(uint32_t bits, int day, DaySchedule& schedule) const {
+        schedule.clear();
+        for (size_t r = 0; r < rules; ++r) schedule.ruleArmed.push_back(static_cast<uint8_t>((bits >> r) & 1));
+        for (const Kind& kind : kinds) {
+            for (uint32_t d = 0; d < kind.width; ++d) {
+                if (bits & (1u << (kind.shift + d))) {
+                    schedule.timers.push_back({ kind.eventId, day + static_cast<int>(d) + 1, kind.period });
+                }
+            }
+        }
+        for (size_t k = 0; k < fields.size(); ++k) {
+            const Field& field = fields[k];
+            const int duration = field.type->duration;
+            const uint32_t value = (bits >> field.shift) & (field.width < 32 ? (1u << field.width) - 1 : ~0u);
+            if (field.type->stacking == Stacking::Independent) {
+                for (int left = 1; left <= duration; ++left) {
+                    if (value & (1u << (left - 1))) {
+                        schedule.modifiers.push_back({ 0, static_cast<int>(k), 1, day + left - duration, day + left });
+                    }
+                }
+            } else if (value != 0) {
+                const int stacks = static_cast<int>(value - 1) / duration + 1;
+                const int left = static_cast<int>(value - 1) % duration + 1;
+                schedule.modifiers.push_back({ 0, static_cast<int>(k), stacks, day + left - duration, day + left });
+            }
+        }
+    }
+
+private:
+    struct Kind {
+        int eventId;
+        uint32_t period;
+        uint32_t shift;
+        uint32_t width;     // farthest day ahead a timer of this kind is due
+    };
+    struct Field {
+        const ModifierType* type;
+        uint32_t shift;
+        uint32_t width;
+    };
+    size_t rules;
+    size_t used;
+    std::vector<Kind> kinds;
+    std::vector<Field> fields;    // by modifier kind
+
+    Kind* find(int eventId, uint32_t period) {
+        for (Kind& kind : kinds) {
+            if (kind.eventId == eventId && kind.period == period) return &kind;
+        }
+        return nullptr;
+    }
+    const Kind* find(int eventId, uint32_t period) const {
+        return const_cast<EventBits*>(this)->find(eventId, period);
+    }
+};
+
+}
+
+namespace StateExplorer {
+
+ExplorerReport run(const DecisionTree& story, const ExplorerConfig& config) {
+    auto start = std::chrono::steady_clock::now();
+
+    ExplorerReport report;
+    report.nodes.assign(story.getNodeCount(), NodeSummary());
+
+    DecisionTree tree;
+    tree.attachStory(story);
+
+    SessionOptions options;
+    options.trackHistory = false;
+    options.keepEventLog = false;
+    options.keepStatHistory = false;
+    options.verbose = false;
+    options.seed = 1;
+    GameSession session(tree, options);
+    GameState& game = session.getState();
+    EventManager& events = session.getEvents();
+
+    EventBits eventBits(events, events.getModifiers());
+    if (!eventBits.fits()) {
+        std::cerr << "Error: stat rules, follow-ups and modifiers need " << eventBits.bitsNeeded() << " of the "
+                  << PackedState::EVENT_BITS << " event bits of an explored state" << std::endl;
+        report.truncated = true;
+        return report;
+    }
+    DaySchedule schedule;
+    auto eventsOf = [&]() {
+        events.saveSchedule(schedule);
+        uint32_t bits;
+        if (!eventBits.pack(schedule, game.day, bits) && !report.truncated) {
+            std::cerr << "Warning: a pending timer or modifier does not fit an explored state; "
+                      << "results are incomplete" << std::endl;
+            report.truncated = true;
+        }
+        return bits;
+    };
+
+    // Without encounters every transition uses a roll that finds nothing
+    std::vector<int> rolls = GameSession::getEncounterRolls();
+    if (!config.randomEncounters) rolls.assign(1, rolls.back());
+
+    std::vector<PackedState> states;
+    StateSet visited(states);
+    ItemTable items(report);
+    int depth = 0;
+
+    auto record = [&](const PackedState& state) {
+        if (!visited.insert(state)) return;
+
+        NodeSummary& summary = report.nodes[state.node];
+        if (summary.minDepth < 0) summary.minDepth = depth;
+        summary.states++;
+        for (int s = 0; s < PackedState::STAT_COUNT; ++s) {
+            int value = state.stat(s);
+            if (value < summary.stats[s].minValue) summary.stats[s].minValue = value;
+            if (value > summary.stats[s].maxValue) summary.stats[s].maxValue = value;
+        }
+        if (state.stat(6) == PackedState::STAT_MAX) report.xpSaturated++;
+    };
+
+    session.restart();
+    Node first = tree.getCurrentNode();
+    if (first.isValid()) {
+        record(PackedState::pack(first.getIndex(), game.stats, items.maskOf(*game.inventory), eventsOf()));
+    }
+
+    // Breadth-first, one level per choice made
+    size_t cursor = 0;
+    while (cursor < states.size() && !report.truncated) {
+        size_t levelEnd = states.size();
+        ++depth;
+
+        for (; cursor < levelEnd; ++cursor) {
+            const PackedState current = states[cursor];
+            const Stats currentStats = current.unpackStats();
+            Node node = tree.getNodeAt(current.node);
+
+            if (node.isEndingNode()) continue;
+            if (currentStats.isDead()) {
+                report.deathStates++;
+                continue;
+            }
+
+            const int choiceCount = static_cast<int>(node.getChoicesWithEffects().size());
+            for (int choice = 0; choice < choiceCount; ++choice) {
+                for (int roll : rolls) {
+                    // Restore the session to this state
+                    game.stats = currentStats;
+                    game.currentNodeId = node.getId();
+                    tree.setCurrentNode(node.getId());
+                    items.fill(*game.inventory, current.inventoryMask());
+                    eventBits.unpack(current.events, game.day, schedule);
+                    events.clear();
+                    events.restoreSchedule(game.day, schedule);
+
+                    session.resolveChoice(choice, roll);
+                    session.drainEvents();
+                    report.transitions++;
+
+                    Node next = tree.getCurrentNode();
+                    if (!next.isValid()) continue;
+                    record(PackedState::pack(next.getIndex(), game.stats, items.maskOf(*game.inventory), eventsOf()));
+                }
+            }
+
+            if (states.size() >= config.maxStates) {
+                report.truncated = true;
+                break;
+            }
+        }
+    }
+
+    for (uint32_t n = 0; n < report.nodes.size(); ++n) {
+        Node node = tree.getNodeAt(n);
+        if (!node.isValid() || !node.isEndingNode()) continue;
+        if (report.nodes[n].states > 0) report.reachableEndings.push_back(n);
+        else report.unreachableEndings.push_back(n);
+    }
+
+    report.states = states.size();
+    report.memoryBytes = states.capacity() * sizeof(PackedState) + visited.memoryUsage();
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return report;
+}
+
+}
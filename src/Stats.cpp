@@ -1,125 +1,110 @@
 #include "Stats.h"
+#include <climits>
 
 // ============================================================
 // CHANGES: Added validateStats() method as described in Listing 6.1
+// Stats are stored as StatEffect lanes; applyEffect is one add + clamp
 // ============================================================
 
-Stats::Stats()
-    : health(100),
-      hunger(0),
-      stamina(100),
-      packStatus(50),
-      morale(75),
-      strength(50),
-      xp(0) {}
+namespace {
+    // Per-lane bounds; XP and the spare lane are unbounded
+    const int32_t LOW[StatEffect::LANES]  = { 0, 0, 0, 0, 0, 0, INT_MIN, INT_MIN };
+    const int32_t HIGH[StatEffect::LANES] = { 100, 100, 100, 100, 100, 100, INT_MAX, INT_MAX };
+}
+
+Stats::Stats() {
+    reset();
+}
 
 // ---------------- Getters ----------------
 
-int Stats::getHealth() const { return health; }
-int Stats::getHunger() const { return hunger; }
-int Stats::getStamina() const { return stamina; }
-int Stats::getPackStatus() const { return packStatus; }
+int Stats::getHealth() const { return getStat(StatId::Health); }
+int Stats::getHunger() const { return getStat(StatId::Hunger); }
+int Stats::getStamina() const { return getStat(StatId::Stamina); }
+int Stats::getPackStatus() const { return getStat(StatId::PackStatus); }
 
-int Stats::getMorale() const { return morale; }
-int Stats::getStrength() const { return strength; }
-int Stats::getXP() const { return xp; }
+int Stats::getMorale() const { return getStat(StatId::Morale); }
+int Stats::getStrength() const { return getStat(StatId::Strength); }
+int Stats::getXP() const { return getStat(StatId::XP); }
 
-// ---------------- Core Logic ----------------
+int Stats::getStat(StatId stat) const {
+    return values[static_cast<int>(stat)];
+}
 
-void Stats::applyEffect(const StatEffect& effect) {
-    health     += effect.healthChange;
-    hunger     += effect.hungerChange;
-    stamina    += effect.staminaChange;
-    packStatus += effect.packStatusChange;
+StatEffect Stats::getValues() const {
+    StatEffect effect;
+    for (int i = 0; i < StatEffect::LANES; ++i) effect.lanes[i] = values[i];
+    return effect;
+}
 
-    morale     += effect.moraleChange;
-    strength   += effect.strengthChange;
-    xp         += effect.xpGain;
+// ---------------- Core Logic ----------------
 
-    clamp(health, 0, 100);
-    clamp(hunger, 0, 100);
-    clamp(stamina, 0, 100);
-    clamp(packStatus, 0, 100);
-    clamp(morale, 0, 100);
-    clamp(strength, 0, 100);
+// Branch-free over all lanes, so the compiler emits vector add/min/max
+void Stats::applyEffect(const StatEffect& effect) {
+    for (int i = 0; i < StatEffect::LANES; ++i) {
+        int32_t v = values[i] + effect.lanes[i];
+        v = v < LOW[i] ? LOW[i] : v;
+        values[i] = v > HIGH[i] ? HIGH[i] : v;
+    }
 }
 
 void Stats::reset() {
-    health = 100;
-    hunger = 0;
-    stamina = 100;
-    packStatus = 50;
-    morale = 75;
-    strength = 50;
-    xp = 0;
+    const StatEffect defaults(100, 0, 100, 50, 75, 50, 0);
+    for (int i = 0; i < StatEffect::LANES; ++i) values[i] = defaults.lanes[i];
 }
 
-// Validate and apply penalties (as described in Listing 6.1)
+// Validate and clamp (as described in Listing 6.1). The daily penalties
+// for low stamina and morale are timed modifiers now, applied by the
+// exhaustion and despair events (see GameSession::registerEvents).
 void Stats::validateStats() {
-    // Hunger penalty
-    if (hunger > 100) {
-        health -= 5;
-    }
-    
-    // Stamina penalty
-    if (stamina < 10) {
-        morale -= 2;
-    }
-    
-    // Morale penalty
-    if (morale < 20) {
-        stamina -= 3;
-    }
-    
-    // Clamp after validation
-    clamp(health, 0, 100);
-    clamp(morale, 0, 100);
-    clamp(stamina, 0, 100);
+    clamp(at(StatId::Health), 0, 100);
+    clamp(at(StatId::Morale), 0, 100);
+    clamp(at(StatId::Stamina), 0, 100);
 }
 
 bool Stats::isDead() const {
-    return health <= 0 || hunger >= 100 || morale <= 0;
+    return getHealth() <= 0 || getHunger() >= 100 || getMorale() <= 0;
 }
 
 bool Stats::canMakeChoice() const {
-    return stamina >= 10 && morale >= 20;
+    return getStamina() >= 10 && getMorale() >= 20;
 }
 
 // ---------------- Setters ----------------
 
 void Stats::setHealth(int value) {
-    health = value;
-    clamp(health, 0, 100);
+    at(StatId::Health) = value;
+    clamp(at(StatId::Health), 0, 100);
 }
 
 void Stats::setHunger(int value) {
-    hunger = value;
-    clamp(hunger, 0, 100);
+    at(StatId::Hunger) = value;
+    clamp(at(StatId::Hunger), 0, 100);
 }
 
 void Stats::setStamina(int value) {
-    stamina = value;
-    clamp(stamina, 0, 100);
+    at(StatId::Stamina) = value;
+    clamp(at(StatId::Stamina), 0, 100);
 }
 
 void Stats::setPackStatus(int value) {
-    packStatus = value;
-    clamp(packStatus, 0, 100);
+    at(StatId::PackStatus) = value;
+    clamp(at(StatId::PackStatus), 0, 100);
 }
 
 void Stats::setMorale(int value) {
-    morale = value;
-    clamp(morale, 0, 100);
+    at(StatId::Morale) = value;
+    clamp(at(StatId::Morale), 0, 100);
 }
 
 void Stats::setStrength(int value) {
-    strength = value;
-    clamp(strength, 0, 100);
+    at(StatId::Strength) = value;
+    clamp(at(StatId::Strength), 0, 100);
 }
 
 void Stats::addXP(int value) {
     if (value > 0)
-        xp += value;
+        at(StatId::XP) += value;
 }
 
 // ---------------- Utility ----------------
@@ -0,0 +1,241 @@
+#include "StatsBlock.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define STATSBLOCK_X86 1
+#endif
+
+// ============================================================
+// StatsBlock Implementation
+// Kernels work on whole vectors and finish the tail in scalar code, so
+// columns need no padding. Deltas beyond +-100 saturate the same way as
+// +-100, which keeps every uniform delta inside one byte.
+// ============================================================
+
+namespace {
+    const int STAT_MAX = 100;
+
+    int limitDelta(int delta) {
+        return delta < -STAT_MAX ? -STAT_MAX : delta > STAT_MAX ? STAT_MAX : delta;
+    }
+
+    // ---------------- Scalar ----------------
+
+    void addScalar(uint8_t* values, size_t n, int delta) {
+        for (size_t i = 0; i < n; ++i) {
+            int v = values[i] + delta;
+            values[i] = static_cast<uint8_t>(v < 0 ? 0 : v > STAT_MAX ? STAT_MAX : v);
+        }
+    }
+
+    void addDeltasScalar(uint8_t* values, const int8_t* deltas, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            int v = values[i] + deltas[i];
+            values[i] = static_cast<uint8_t>(v < 0 ? 0 : v > STAT_MAX ? STAT_MAX : v);
+        }
+    }
+
+#ifdef STATSBLOCK_X86
+    // ---------------- SSE2 ----------------
+
+    // A signed byte delta splits into an unsigned add and an unsigned
+    // subtract; -128 negates to 0x80, which reads as 128 unsigned
+    __attribute__((target("sse2")))
+    void addSse2(uint8_t* values, size_t n, int delta) {
+        const __m128i up = _mm_set1_epi8(static_cast<char>(delta > 0 ? delta : 0));
+        const __m128i down = _mm_set1_epi8(static_cast<char>(delta < 0 ? -delta : 0));
+        const __m128i max = _mm_set1_epi8(STAT_MAX);
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+            v = _mm_min_epu8(_mm_subs_epu8(_mm_adds_epu8(v, up), down), max);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(values + i), v);
+        }
+        addScalar(values + i, n - i, delta);
+    }
+
+    __attribute__((target("sse2")))
+    void addDeltasSse2(uint8_t* values, const int8_t* deltas, size_t n) {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i max = _mm_set1_epi8(STAT_MAX);
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+            __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(deltas + i));
+            __m128i negative = _mm_cmpgt_epi8(zero, d);
+            __m128i up = _mm_andnot_si128(negative, d);
+            __m128i down = _mm_and_si128(negative, _mm_sub_epi8(zero, d));
+            v = _mm_min_epu8(_mm_subs_epu8(_mm_adds_epu8(v, up), down), max);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(values + i), v);
+        }
+        addDeltasScalar(values + i, deltas + i, n - i);
+    }
+
+    // ---------------- AVX2 ----------------
+
+    __attribute__((target("avx2")))
+    void addAvx2(uint8_t* values, size_t n, int delta) {
+        const __m256i up = _mm256_set1_epi8(static_cast<char>(delta > 0 ? delta : 0));
+        const __m256i down = _mm256_set1_epi8(static_cast<char>(delta < 0 ? -delta : 0));
+        const __m256i max = _mm256_set1_epi8(STAT_MAX);
+        size_t i = 0;
+        for (; i + 32 <= n; i += 32) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+            v = _mm256_min_epu8(_mm256_subs_epu8(_mm256_adds_epu8(v, up), down), max);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(values + i), v);
+        }
+        addScalar(values + i, n - i, delta);
+    }
+
+    __attribute__((target("avx2")))
+    void addDeltasAvx2(uint8_t* values, const int8_t* deltas, size_t n) {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i max = _mm256_set1_epi8(STAT_MAX);
+        size_t i = 0;
+        for (; i + 32 <= n; i += 32) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+            __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(deltas + i));
+            __m256i negative = _mm256_cmpgt_epi8(zero, d);
+            __m256i up = _mm256_andnot_si256(negative, d);
+            __m256i down = _mm256_and_si256(negative, _mm256_sub_epi8(zero, d));
+            v = _mm256_min_epu8(_mm256_subs_epu8(_mm256_adds_epu8(v, up), down), max);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(values + i), v);
+        }
+        addDeltasScalar(values + i, deltas + i, n - i);
+    }
+#endif
+
+    // ---------------- Dispatch ----------------
+
+    bool supports(SimdLevel level) {
+#ifdef STATSBLOCK_X86
+        __builtin_cpu_init();
+        if (level == SimdLevel::AVX2) return __builtin_cpu_supports("avx2");
+        if (level == SimdLevel::SSE2) return __builtin_cpu_supports("sse2");
+#endif
+        return level == SimdLevel::Scalar;
+    }
+
+    SimdLevel bestLevel() {
+        if (supports(SimdLevel::AVX2)) return SimdLevel::AVX2;
+        if (supports(SimdLevel::SSE2)) return SimdLevel::SSE2;
+        return SimdLevel::Scalar;
+    }
+
+    SimdLevel activeLevel = bestLevel();
+
+    void addUniform(uint8_t* values, size_t n, int delta) {
+#ifdef STATSBLOCK_X86
+        if (activeLevel == SimdLevel::AVX2) return addAvx2(values, n, delta);
+        if (activeLevel == SimdLevel::SSE2) return addSse2(values, n, delta);
+#endif
+        addScalar(values, n, delta);
+    }
+
+    void addPerEntity(uint8_t* values, const int8_t* deltas, size_t n) {
+#ifdef STATSBLOCK_X86
+        if (activeLevel == SimdLevel::AVX2) return addDeltasAvx2(values, deltas, n);
+        if (activeLevel == SimdLevel::SSE2) return addDeltasSse2(values, deltas, n);
+#endif
+        addDeltasScalar(values, deltas, n);
+    }
+}
+
+StatsBlock::StatsBlock(size_t count) : count(0) {
+    resize(count);
+}
+
+void StatsBlock::resize(size_t newCount) {
+    const Stats defaults;
+    for (int s = 0; s < CLAMPED_COUNT; ++s) {
+        lanes[s].resize(newCount, static_cast<uint8_t>(defaults.getStat(static_cast<StatId>(s))));
+    }
+    xp.resize(newCount, defaults.getXP());
+    count = newCount;
+}
+
+size_t StatsBlock::size() const {
+    return count;
+}
+
+// ---------------- Entities ----------------
+
+void StatsBlock::set(size_t index, const Stats& stats) {
+    for (int s = 0; s < CLAMPED_COUNT; ++s) {
+        lanes[s][index] = static_cast<uint8_t>(stats.getStat(static_cast<StatId>(s)));
+    }
+    xp[index] = stats.getXP();
+}
+
+Stats StatsBlock::get(size_t index) const {
+    Stats stats;
+    stats.setHealth(lanes[static_cast<int>(StatId::Health)][index]);
+    stats.setHunger(lanes[static_cast<int>(StatId::Hunger)][index]);
+    stats.setStamina(lanes[static_cast<int>(StatId::Stamina)][index]);
+    stats.setPackStatus(lanes[static_cast<int>(StatId::PackStatus)][index]);
+    stats.setMorale(lanes[static_cast<int>(StatId::Morale)][index]);
+    stats.setStrength(lanes[static_cast<int>(StatId::Strength)][index]);
+    stats.applyEffect(StatEffect(0, 0, 0, 0, 0, 0, xp[index]));
+    return stats;
+}
+
+int StatsBlock::getStat(size_t index, StatId stat) const {
+    return stat == StatId::XP ? xp[index] : lanes[static_cast<int>(stat)][index];
+}
+
+uint8_t* StatsBlock::column(StatId stat) {
+    return lanes[static_cast<int>(stat)].data();
+}
+
+const uint8_t* StatsBlock::column(StatId stat) const {
+    return lanes[static_cast<int>(stat)].data();
+}
+
+int* StatsBlock::xpColumn() {
+    return xp.data();
+}
+
+const int* StatsBlock::xpColumn() const {
+    return xp.data();
+}
+
+// ---------------- Bulk Updates ----------------
+
+void StatsBlock::applyEffect(const StatEffect& effect) {
+    for (int s = 0; s < CLAMPED_COUNT; ++s) {
+        if (effect.lanes[s] != 0) addUniform(lanes[s].data(), count, limitDelta(effect.lanes[s]));
+    }
+    const int gain = effect[StatId::XP];
+    if (gain != 0) {
+        for (int& value : xp) value += gain;
+    }
+}
+
+void StatsBlock::applyDeltas(StatId stat, const int8_t* deltas) {
+    if (stat == StatId::XP) {
+        for (size_t i = 0; i < count; ++i) xp[i] += deltas[i];
+        return;
+    }
+    addPerEntity(lanes[static_cast<int>(stat)].data(), deltas, count);
+}
+
+// ---------------- Kernel Selection ----------------
+
+SimdLevel StatsBlock::getSimdLevel() {
+    return activeLevel;
+}
+
+bool StatsBlock::setSimdLevel(SimdLevel level) {
+    if (!supports(level)) return false;
+    activeLevel = level;
+    return true;
+}
+
+const char* StatsBlock::getSimdName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::AVX2:   return "avx2";
+        case SimdLevel::SSE2:   return "sse2";
+        case SimdLevel::Scalar: return "scalar";
+    }
+    return "scalar";
+}
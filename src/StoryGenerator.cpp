@@ -0,0 +1,124 @@
+#include "StoryGenerator.h"
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// ============================================================
+// StoryGenerator Implementation
+// ============================================================
+
+namespace {
+
+const char* const WORDS[] = {
+    "snow", "wind", "ridge", "pack", "scent", "prey", "howl", "frozen", "river", "pine",
+    "tracks", "shadow", "den", "hunger", "moon", "storm", "cliff", "elk", "ice", "silence",
+    "distant", "wary", "cold", "trail", "bones", "valley", "rival", "ancient", "fog", "thaw"
+};
+const int WORD_COUNT = sizeof(WORDS) / sizeof(WORDS[0]);
+
+void appendText(std::string& out, std::mt19937_64& rng, int words) {
+    for (int w = 0; w < words; ++w) {
+        out += ' ';
+        out += WORDS[rng() % WORD_COUNT];
+    }
+}
+
+int uniform(std::mt19937_64& rng, int lo, int hi) {
+    return lo + static_cast<int>(rng() % static_cast<uint64_t>(hi - lo + 1));
+}
+
+}
+
+namespace StoryGenerator {
+
+void generateNodes(const GeneratorConfig& config, const std::function<void(const StoryNodeDef&)>& onNode) {
+    const int count = static_cast<int>(config.nodeCount);
+    if (count <= 0) return;
+
+    std::mt19937_64 rng(config.seed);
+    std::uniform_real_distribution<double> chance(0.0, 1.0);
+
+    std::vector<uint8_t> ending(static_cast<size_t>(count) + 1, 0);
+    for (int id = 2; id < count; ++id) ending[id] = chance(rng) < config.endingRatio;
+    ending[count] = 1;
+
+    StoryNodeDef node;
+    for (int id = 1; id <= count; ++id) {
+        node.id = id;
+        node.ending = ending[id] != 0;
+        node.text = "Node " + std::to_string(id) + ".";
+        appendText(node.text, rng, config.textWords);
+        node.endingType = node.ending ? "Generated ending " + std::to_string(id) : std::string();
+        node.choices.clear();
+        node.triggers.clear();
+
+        if (!node.ending) {
+            // Link the following endings and the next non-ending node
+            std::vector<int> targets;
+            for (int next = id + 1; next <= count; ++next) {
+                targets.push_back(next);
+                if (!ending[next]) break;
+            }
+            while (static_cast<int>(targets.size()) < config.branching) {
+                if (chance(rng) < config.cycleDensity) {
+                    targets.push_back(uniform(rng, id > config.window ? id - config.window : 1, id));
+                } else {
+                    int last = id + config.window < count ? id + config.window : count;
+                    targets.push_back(uniform(rng, id + 1, last));
+                }
+            }
+
+            for (int target : targets) {
+                StoryChoiceDef choice;
+                choice.target = target;
+                choice.text = "Go on";
+                appendText(choice.text, rng, 3);
+                for (int e = 0; e < config.effectsPerChoice; ++e) {
+                    choice.effects.push_back(StatEffect(uniform(rng, -5, 5), uniform(rng, 0, 10),
+                                                        uniform(rng, -15, 5), uniform(rng, -5, 5),
+                                                        uniform(rng, -5, 5), uniform(rng, -2, 2),
+                                                        uniform(rng, 0, 10)));
+                }
+                node.choices.push_back(choice);
+            }
+        }
+
+        for (int t = 0; t < config.triggersPerNode; ++t) {
+            node.triggers.push_back(uniform(rng, 1, 10));
+        }
+
+        onNode(node);
+    }
+}
+
+void generate(DecisionTree& tree, const GeneratorConfig& config) {
+    generateNodes(config, [&tree](const StoryNodeDef& node) { StoryParser::addNode(tree, node); });
+    tree.finalize();
+}
+
+bool writeSource(const std::string& filename, const GeneratorConfig& config) {
+    std::FILE* file = std::fopen(filename.c_str(), "w");
+    if (!file) return false;
+
+    std::fprintf(file, "# Generated story: %u nodes, seed %llu\n", config.nodeCount,
+                 static_cast<unsigned long long>(config.seed));
+    generateNodes(config, [file](const StoryNodeDef& node) {
+        std::fprintf(file, "\nnode %d\ntext %s\n", node.id, node.text.c_str());
+        if (node.ending) std::fprintf(file, "ending %s\n", node.endingType.c_str());
+        for (const StoryChoiceDef& choice : node.choices) {
+            std::fprintf(file, "choice %d | %s", choice.target, choice.text.c_str());
+            for (size_t e = 0; e < choice.effects.size(); ++e) {
+                const StatEffect& fx = choice.effects[e];
+                std::fprintf(file, "%s%d %d %d %d %d %d %d", e == 0 ? " | " : "; ",
+                             fx[StatId::Health], fx[StatId::Hunger], fx[StatId::Stamina], fx[StatId::PackStatus],
+                             fx[StatId::Morale], fx[StatId::Strength], fx[StatId::XP]);
+            }
+            std::fprintf(file, "\n");
+        }
+        for (int eventId : node.triggers) std::fprintf(file, "trigger %d\n", eventId);
+    });
+
+    return std::fclose(file) == 0;
+}
+
+}
@@ -0,0 +1,323 @@
+#include "StoryImage.h"
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// ============================================================
+// Compiled story image: mmap/MapViewOfFile loader and writer
+// ============================================================
+
+using namespace StoryFormat;
+
+static_assert(sizeof(Header) == 96, "story image header layout changed");
+static_assert(sizeof(NodeRecord) == 40, "node record layout changed");
+static_assert(sizeof(ChoiceRecord) == 28, "choice record layout changed");
+static_assert(sizeof(EffectRecord) == 28, "effect record layout changed");
+
+namespace {
+
+uint64_t alignUp(uint64_t value) {
+    return (value + SECTION_ALIGN - 1) & ~static_cast<uint64_t>(SECTION_ALIGN - 1);
+}
+
+bool sectionFits(uint64_t offset, uint64_t count, uint64_t elementSize, uint64_t fileSize) {
+    if (offset % alignof(uint32_t) != 0 || offset > fileSize) return false;
+    return count <= (fileSize - offset) / elementSize;
+}
+
+// [first, first + count) lies within a table of 'size' entries
+bool rangeFits(uint64_t first, uint64_t count, uint64_t size) {
+    return first <= size && count <= size - first;
+}
+
+// Text and effects inside their tables, and a target that names its node.
+// Images never hold dangling choices: makeChoice() moves straight to the
+// target index, so NO_INDEX would strand the session on no node.
+bool choiceFits(const Header& h, const NodeRecord* nodes, const ChoiceRecord& choice) {
+    if (!rangeFits(choice.textOffset, choice.textLength, h.stringSize) ||
+        !rangeFits(choice.firstEffect, choice.effectCount, h.effectCount)) {
+        return false;
+    }
+    if (choice.foldedEffect != NO_INDEX && choice.foldedEffect >= h.effectCount) return false;
+    return choice.targetIndex < h.nodeCount && nodes[choice.targetIndex].id == choice.targetNodeId;
+}
+
+// The node's strings, choice and trigger ranges, and each of its choices
+bool nodeFits(const Header& h, const NodeRecord* nodes, const ChoiceRecord* choices, uint32_t index) {
+    const NodeRecord& node = nodes[index];
+    if (!rangeFits(node.textOffset, node.textLength, h.stringSize) ||
+        !rangeFits(node.endingOffset, node.endingLength, h.stringSize) ||
+        !rangeFits(node.firstChoice, node.choiceCount, h.choiceCount) ||
+        !rangeFits(node.firstTrigger, node.triggerCount, h.triggerCount)) {
+        return false;
+    }
+    for (uint32_t c = 0; c < node.choiceCount; ++c) {
+        if (!choiceFits(h, nodes, choices[node.firstChoice + c])) return false;
+    }
+    return true;
+}
+
+}
+
+StoryImage::StoryImage()
+    : data(nullptr), size(0),
+#ifdef _WIN32
+      fileHandle(nullptr), mappingHandle(nullptr)
+#else
+      fileDescriptor(-1)
+#endif
+{}
+
+StoryImage::~StoryImage() {
+    close();
+}
+
+bool StoryImage::open(const std::string& filename) {
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart < static_cast<LONGLONG>(sizeof(Header))) {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    fileHandle = file;
+    mappingHandle = mapping;
+    data = static_cast<const unsigned char*>(view);
+    size = static_cast<size_t>(fileSize.QuadPart);
+#else
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(Header))) {
+        ::close(fd);
+        return false;
+    }
+
+    void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    if (view == MAP_FAILED) {
+        ::close(fd);
+        return false;
+    }
+
+    fileDescriptor = fd;
+    data = static_cast<const unsigned char*>(view);
+    size = static_cast<size_t>(info.st_size);
+#endif
+
+    if (!validate()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void StoryImage::close() {
+    if (!data) return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(data);
+    CloseHandle(static_cast<HANDLE>(mappingHandle));
+    CloseHandle(static_cast<HANDLE>(fileHandle));
+    fileHandle = nullptr;
+    mappingHandle = nullptr;
+#else
+    munmap(const_cast<unsigned char*>(data), size);
+    ::close(fileDescriptor);
+    fileDescriptor = -1;
+#endif
+
+    data = nullptr;
+    size = 0;
+}
+
+bool StoryImage::isOpen() const {
+    return data != nullptr;
+}
+
+// Header and section bounds only, so opening costs the same for any
+// story size; records are checked per node by checkNode()
+bool StoryImage::validate() const {
+    const Header& h = getHeader();
+    if (h.magic != MAGIC || h.version != VERSION) return false;
+    if (h.fileSize != size) return false;
+
+    const bool sectionsFit =
+        sectionFits(h.nodeOffset, h.nodeCount, sizeof(NodeRecord), size) &&
+        sectionFits(h.choiceOffset, h.choiceCount, sizeof(ChoiceRecord), size) &&
+        sectionFits(h.effectOffset, h.effectCount, sizeof(EffectRecord), size) &&
+        sectionFits(h.triggerOffset, h.triggerCount, sizeof(int32_t), size) &&
+        sectionFits(h.idTableOffset, h.idTableSize, sizeof(uint32_t), size) &&
+        sectionFits(h.stringOffset, h.stringSize, 1, size);
+    return sectionsFit;
+}
+
+bool StoryImage::checkNode(uint32_t index) const {
+    if (!data || index >= getHeader().nodeCount) return false;
+    return nodeFits(getHeader(), getNodes(), getChoices(), index);
+}
+
+const Header& StoryImage::getHeader() const {
+    return *reinterpret_cast<const Header*>(data);
+}
+
+const NodeRecord* StoryImage::getNodes() const {
+    return reinterpret_cast<const NodeRecord*>(data + getHeader().nodeOffset);
+}
+
+const ChoiceRecord* StoryImage::getChoices() const {
+    return reinterpret_cast<const ChoiceRecord*>(data + getHeader().choiceOffset);
+}
+
+const EffectRecord* StoryImage::getEffects() const {
+    return reinterpret_cast<const EffectRecord*>(data + getHeader().effectOffset);
+}
+
+const int32_t* StoryImage::getTriggers() const {
+    return reinterpret_cast<const int32_t*>(data + getHeader().triggerOffset);
+}
+
+const uint32_t* StoryImage::getIdTable() const {
+    return reinterpret_cast<const uint32_t*>(data + getHeader().idTableOffset);
+}
+
+const char* StoryImage::getStrings() const {
+    return reinterpret_cast<const char*>(data + getHeader().stringOffset);
+}
+
+uint32_t StoryImage::findNode(int id) const {
+    if (!data) return NO_INDEX;
+    const Header& h = getHeader();
+
+    if (h.idTableSize > 0) {
+        int64_t slot = static_cast<int64_t>(id) - h.idBase;
+        if (slot < 0 || slot >= h.idTableSize) return NO_INDEX;
+        const uint32_t index = getIdTable()[slot];
+        return (index < h.nodeCount && getNodes()[index].id == id) ? index : NO_INDEX;
+    }
+
+    // Sparse IDs: node table is sorted by id
+    const NodeRecord* nodes = getNodes();
+    uint32_t lo = 0, hi = h.nodeCount;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (nodes[mid].id < id) lo = mid + 1;
+        else hi = mid;
+    }
+    return (lo < h.nodeCount && nodes[lo].id == id) ? lo : NO_INDEX;
+}
+
+// ---------------- Writer ----------------
+
+bool StoryImage::write(const std::string& filename,
+                       const std::vector<NodeRecord>& nodes,
+                       const std::vector<ChoiceRecord>& choices,
+                       const std::vector<EffectRecord>& effects,
+                       const std::vector<int32_t>& triggers,
+                       const std::string& strings) {
+    for (size_t i = 1; i < nodes.size(); ++i) {
+        if (nodes[i - 1].id >= nodes[i].id) return false;  // must be sorted and unique
+    }
+
+    Header h;
+    std::memset(&h, 0, sizeof(h));
+    h.magic = MAGIC;
+    h.version = VERSION;
+    h.nodeCount = static_cast<uint32_t>(nodes.size());
+    h.choiceCount = static_cast<uint32_t>(choices.size());
+    h.effectCount = static_cast<uint32_t>(effects.size());
+    h.triggerCount = static_cast<uint32_t>(triggers.size());
+
+    // Emit a direct lookup table when IDs are reasonably dense
+    std::vector<uint32_t> idTable;
+    if (!nodes.empty()) {
+        int64_t range = static_cast<int64_t>(nodes.back().id) - nodes.front().id + 1;
+        if (range <= 2 * static_cast<int64_t>(nodes.size()) + 64) {
+            h.idBase = nodes.front().id;
+            idTable.assign(static_cast<size_t>(range), NO_INDEX);
+            for (size_t i = 0; i < nodes.size(); ++i)
+                idTable[static_cast<size_t>(nodes[i].id - h.idBase)] = static_cast<uint32_t>(i);
+        }
+    }
+    h.idTableSize = static_cast<uint32_t>(idTable.size());
+    h.stringSize = strings.size();
+
+    // Every record must pass the checks readers make per node
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        if (!nodeFits(h, nodes.data(), choices.data(), static_cast<uint32_t>(i))) return false;
+    }
+    for (const ChoiceRecord& choice : choices) {
+        if (!choiceFits(h, nodes.data(), choice)) return false;
+    }
+
+    uint64_t offset = alignUp(sizeof(Header));
+    h.nodeOffset = offset;
+    offset = alignUp(offset + nodes.size() * sizeof(NodeRecord));
+    h.choiceOffset = offset;
+    offset = alignUp(offset + choices.size() * sizeof(ChoiceRecord));
+    h.effectOffset = offset;
+    offset = alignUp(offset + effects.size() * sizeof(EffectRecord));
+    h.triggerOffset = offset;
+    offset = alignUp(offset + triggers.size() * sizeof(int32_t));
+    h.idTableOffset = offset;
+    offset = alignUp(offset + idTable.size() * sizeof(uint32_t));
+    h.stringOffset = offset;
+    h.fileSize = offset + strings.size();
+
+    FILE* file = std::fopen(filename.c_str(), "wb");
+    if (!file) return false;
+
+    bool ok = true;
+    uint64_t written = 0;
+    auto put = [&](const void* bytes, uint64_t count, uint64_t at) {
+        static const char padding[SECTION_ALIGN] = {};
+        while (ok && written < at) {
+            uint64_t gap = at - written;
+            size_t chunk = static_cast<size_t>(gap < SECTION_ALIGN ? gap : SECTION_ALIGN);
+            ok = std::fwrite(padding, 1, chunk, file) == chunk;
+            written += chunk;
+        }
+        if (ok && count > 0) {
+            ok = std::fwrite(bytes, 1, static_cast<size_t>(count), file) == count;
+            written += count;
+        }
+    };
+
+    put(&h, sizeof(h), 0);
+    put(nodes.data(), nodes.size() * sizeof(NodeRecord), h.nodeOffset);
+    put(choices.data(), choices.size() * sizeof(ChoiceRecord), h.choiceOffset);
+    put(effects.data(), effects.size() * sizeof(EffectRecord), h.effectOffset);
+    put(triggers.data(), triggers.size() * sizeof(int32_t), h.triggerOffset);
+    put(idTable.data(), idTable.size() * sizeof(uint32_t), h.idTableOffset);
+    put(strings.data(), strings.size(), h.stringOffset);
+
+    if (std::fclose(file) != 0) ok = false;
+    return ok;
+}
@@ -0,0 +1,487 @@
+#include "StoryParser.h"
+#include <fstream>
+#include <sstream>
+
+// ============================================================
+// Text story reader - feeds DecisionTree's builder API
+// ============================================================
+
+namespace {
+
+struct PendingNode {
+    bool open = false;
+    StoryNodeDef def;
+};
+
+std::string trim(const std::string& s) {
+    size_t begin = s.find_first_not_of(" \t\r");
+    if (begin == std::string::npos) return "";
+    size_t end = s.find_last_not_of(" \t\r");
+    return s.substr(begin, end - begin + 1);
+}
+
+bool parseInt(const std::string& s, int& out) {
+    std::istringstream in(trim(s));
+    in >> out;
+    return !in.fail() && in.eof();
+}
+
+bool parseEffect(const std::string& s, StatEffect& out) {
+    std::istringstream in(s);
+    int values[7] = {0, 0, 0, 0, 0, 0, 0};
+    int count = 0;
+    int value;
+    while (in >> value) {
+        if (count == 7) return false;
+        values[count++] = value;
+    }
+    if (!in.eof() || count == 0) return false;
+
+    out = StatEffect(values[0], values[1], values[2], values[3], values[4], values[5], values[6]);
+    return true;
+}
+
+// choice <target> | <text> [| <effect> [; <effect> ...]]
+bool parseChoice(const std::string& rest, StoryChoiceDef& out) {
+    size_t bar1 = rest.find('|');
+    if (bar1 == std::string::npos) return false;
+    if (!parseInt(rest.substr(0, bar1), out.target)) return false;
+
+    size_t bar2 = rest.find('|', bar1 + 1);
+    out.text = trim(rest.substr(bar1 + 1, bar2 == std::string::npos ? std::string::npos : bar2 - bar1 - 1));
+    if (bar2 == std::string::npos) return true;
+
+    std::string effects = rest.substr(bar2 + 1);
+    size_t start = 0;
+    while (start <= effects.size()) {
+        size_t semi = effects.find(';', start);
+        std::string part = trim(effects.substr(start, semi == std::string::npos ? std::string::npos : semi - start));
+        if (!part.empty()) {
+            StatEffect effect;
+            if (!parseEffect(part, effect)) return false;
+            out.effects.push_back(effect);
+        }
+        if (semi == std::string::npos) break;
+        start = semi + 1;
+    }
+    return true;
+}
+
+bool parsePriority(const std::string& s, Priority& out) {
+    static const char* const NAMES[] = { "LOW", "MEDIUM", "HIGH", "CRITICAL" };
+    for (int i = 0; i < 4; ++i) {
+        if (s == NAMES[i]) {
+            out = static_cast<Priority>(i + 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+struct EventDef {
+    int id = 0;
+    Priority priority = Priority::MEDIUM;
+    std::string description;
+    StatEffect effect;
+};
+
+// event <id> | <priority> | <description> [| <effect>]
+bool parseEvent(const std::string& rest, EventDef& out) {
+    size_t bar1 = rest.find('|');
+    size_t bar2 = bar1 == std::string::npos ? std::string::npos : rest.find('|', bar1 + 1);
+    if (bar2 == std::string::npos) return false;
+    if (!parseInt(rest.substr(0, bar1), out.id)) return false;
+    if (!parsePriority(trim(rest.substr(bar1 + 1, bar2 - bar1 - 1)), out.priority)) return false;
+
+    size_t bar3 = rest.find('|', bar2 + 1);
+    out.description = trim(rest.substr(bar2 + 1, bar3 == std::string::npos ? std::string::npos : bar3 - bar2 - 1));
+    if (bar3 == std::string::npos) return true;
+    return parseEffect(trim(rest.substr(bar3 + 1)), out.effect);
+}
+
+bool parseStat(const std::string& s, StatId& out) {
+    static const char* const NAMES[] = { "health", "hunger", "stamina", "packStatus", "morale", "strength", "xp" };
+    for (int i = 0; i < STAT_COUNT; ++i) {
+        if (s == NAMES[i]) {
+            out = static_cast<StatId>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+// rule <stat> <'<'|'>'> <threshold> | <hysteresis> | <event id>
+bool parseRule(const std::string& rest, StatRule& out) {
+    size_t bar1 = rest.find('|');
+    size_t bar2 = bar1 == std::string::npos ? std::string::npos : rest.find('|', bar1 + 1);
+    if (bar2 == std::string::npos) return false;
+
+    std::istringstream condition(rest.substr(0, bar1));
+    std::string stat, op;
+    int threshold;
+    if (!(condition >> stat >> op >> threshold) || !parseStat(stat, out.stat)) return false;
+    if (op == "<") out.comparator = Comparator::Below;
+    else if (op == ">") out.comparator = Comparator::Above;
+    else return false;
+    out.threshold = threshold;
+
+    return parseInt(rest.substr(bar1 + 1, bar2 - bar1 - 1), out.hysteresis) &&
+           parseInt(rest.substr(bar2 + 1), out.eventId);
+}
+
+struct FollowUpDef {
+    int eventId = 0;
+    int followUpId = 0;
+    int delayDays = 0;
+    int periodDays = 0;
+};
+
+// followup <event id> | <delay days> | <event id> [| <period days>]
+bool parseFollowUp(const std::string& rest, FollowUpDef& out) {
+    std::vector<std::string> parts;
+    size_t start = 0;
+    for (;;) {
+        size_t bar = rest.find('|', start);
+        parts.push_back(rest.substr(start, bar == std::string::npos ? std::string::npos : bar - start));
+        if (bar == std::string::npos) break;
+        start = bar + 1;
+    }
+    if (parts.size() < 3 || parts.size() > 4) return false;
+    if (!parseInt(parts[0], out.eventId) || !parseInt(parts[1], out.delayDays) ||
+        !parseInt(parts[2], out.followUpId)) return false;
+    if (parts.size() == 4 && !parseInt(parts[3], out.periodDays)) return false;
+    return out.delayDays >= 0 && out.periodDays >= 0;
+}
+
+struct ModifierDef {
+    std::string name;
+    ModifierType type;
+};
+
+// Split on '|' into trimmed parts
+std::vector<std::string> splitBars(const std::string& rest) {
+    std::vector<std::string> parts;
+    size_t start = 0;
+    for (;;) {
+        size_t bar = rest.find('|', start);
+        parts.push_back(trim(rest.substr(start, bar == std::string::npos ? std::string::npos : bar - start)));
+        if (bar == std::string::npos) break;
+        start = bar + 1;
+    }
+    return parts;
+}
+
+// refresh | stack <max stacks> | independent
+bool parseStacking(const std::string& s, ModifierType& out) {
+    std::istringstream in(s);
+    std::string mode;
+    in >> mode;
+    if (mode == "refresh") out.stacking = Stacking::Refresh;
+    else if (mode == "independent") out.stacking = Stacking::Independent;
+    else if (mode == "stack") {
+        int maxStacks = 0;
+        if (!(in >> maxStacks) || maxStacks < 1 || maxStacks > 0xFFFF) return false;
+        out.stacking = Stacking::Stack;
+        out.maxStacks = static_cast<uint16_t>(maxStacks);
+    } else {
+        return false;
+    }
+    std::string extra;
+    return !(in >> extra);
+}
+
+bool parseDecay(const std::string& s, Decay& out) {
+    if (s == "none") out = Decay::None;
+    else if (s == "linear") out = Decay::Linear;
+    else if (s == "halving") out = Decay::Halving;
+    else return false;
+    return true;
+}
+
+// modifier <name> | <duration days> | <effect per day> [| <stacking> [| <decay>]]
+bool parseModifier(const std::string& rest, ModifierDef& out) {
+    std::vector<std::string> parts = splitBars(rest);
+    if (parts.size() < 3 || parts.size() > 5) return false;
+    out.name = parts[0];
+    int duration = 0;
+    if (out.name.empty() || out.name.find_first_of(" \t") != std::string::npos ||
+        !parseInt(parts[1], duration) || duration < 1 || duration > 0xFFFF ||
+        !parseEffect(parts[2], out.type.effect)) {
+        return false;
+    }
+    out.type.duration = static_cast<uint16_t>(duration);
+    if (parts.size() >= 4 && !parseStacking(parts[3], out.type)) return false;
+    return parts.size() < 5 || parseDecay(parts[4], out.type.decay);
+}
+
+struct ApplyDef {
+    int eventId = 0;
+    std::string modifier;
+};
+
+// apply <event id> | <modifier name>
+bool parseApply(const std::string& rest, ApplyDef& out) {
+    std::vector<std::string> parts = splitBars(rest);
+    if (parts.size() != 2 || !parseInt(parts[0], out.eventId)) return false;
+    out.modifier = parts[1];
+    return !out.modifier.empty();
+}
+
+void flush(PendingNode& node, const std::function<void(const StoryNodeDef&)>& onNode) {
+    if (!node.open) return;
+    onNode(node.def);
+    node = PendingNode();
+}
+
+}
+
+namespace StoryParser {
+
+bool parseNodes(std::istream& in, const std::function<void(const StoryNodeDef&)>& onNode,
+                std::string& error, int firstLine) {
+    PendingNode node;
+    std::string line;
+    int lineNumber = firstLine - 1;
+
+    auto fail = [&](const std::string& message) {
+        error = "line " + std::to_string(lineNumber) + ": " + message;
+        return false;
+    };
+
+    while (std::getline(in, line)) {
+        ++lineNumber;
+        std::string content = trim(line);
+        if (content.empty() || content[0] == '#') continue;
+
+        size_t space = content.find_first_of(" \t");
+        std::string keyword = content.substr(0, space);
+        std::string rest = space == std::string::npos ? "" : trim(content.substr(space + 1));
+
+        if (keyword == "node") {
+            flush(node, onNode);
+            if (!parseInt(rest, node.def.id)) return fail("invalid node id '" + rest + "'");
+            node.open = true;
+            continue;
+        }
+
+        if (!node.open) return fail("'" + keyword + "' outside of a node block");
+
+        if (keyword == "text") {
+            node.def.text = rest;
+        } else if (keyword == "ending") {
+            node.def.ending = true;
+            node.def.endingType = rest;
+        } else if (keyword == "choice") {
+            StoryChoiceDef choice;
+            if (!parseChoice(rest, choice)) return fail("malformed choice");
+            node.def.choices.push_back(choice);
+        } else if (keyword == "trigger") {
+            int eventId;
+            if (!parseInt(rest, eventId)) return fail("invalid event id '" + rest + "'");
+            node.def.triggers.push_back(eventId);
+        } else {
+            return fail("unknown keyword '" + keyword + "'");
+        }
+    }
+
+    flush(node, onNode);
+    return true;
+}
+
+void addNode(DecisionTree& tree, const StoryNodeDef& node) {
+    tree.createNode(node.id, node.text, node.ending);
+    if (node.ending) tree.setNodeEndingType(node.id, node.endingType);
+    for (const StoryChoiceDef& choice : node.choices) {
+        tree.addChoice(node.id, choice.text, choice.target, choice.effects);
+    }
+    for (int eventId : node.triggers) {
+        tree.addTrigger(node.id, eventId);
+    }
+}
+
+bool parse(std::istream& in, DecisionTree& tree, std::string& error) {
+    bool ok = parseNodes(in, [&tree](const StoryNodeDef& node) { addNode(tree, node); }, error);
+    if (!ok) return false;
+    tree.finalize();
+    return true;
+}
+
+bool loadFile(const std::string& filename, DecisionTree& tree, std::string& error) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        error = "cannot open " + filename;
+        return false;
+    }
+    return parse(file, tree, error);
+}
+
+bool loadStory(const std::string& path, DecisionTree& tree, std::string& error) {
+    if (path.empty()) {
+        tree.loadNodes();
+        return true;
+    }
+    if (path.size() > 4 && path.compare(path.size() - 4, 4, ".wsb") == 0) {
+        if (tree.loadFromImage(path)) return true;
+        error = "not a valid story image";
+        return false;
+    }
+    return loadFile(path, tree, error);
+}
+
+bool loadEvents(const std::string& filename, EventManager& events, std::string& error) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        error = "cannot open " + filename;
+        return false;
+    }
+
+    // Parse everything first so the registry is sized once
+    std::vector<EventDef> defs;
+    std::vector<int> lines;
+    std::vector<StatRule> rules;
+    std::vector<int> ruleLines;
+    std::vector<FollowUpDef> followUpDefs;
+    std::vector<int> followUpLines;
+    std::vector<ModifierDef> modifierDefs;
+    std::vector<int> modifierLines;
+    std::vector<ApplyDef> applyDefs;
+    std::vector<int> applyLines;
+    std::string line;
+    int lineNumber = 0;
+    int maxId = -1;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        std::string content = trim(line);
+        if (content.empty() || content[0] == '#') continue;
+
+        size_t space = content.find_first_of(" \t");
+        std::string keyword = content.substr(0, space);
+        std::string rest = space == std::string::npos ? "" : trim(content.substr(space + 1));
+
+        if (keyword == "followup") {
+            FollowUpDef followUp;
+            if (!parseFollowUp(rest, followUp)) {
+                error = "line " + std::to_string(lineNumber) + ": malformed followup";
+                return false;
+            }
+            followUpDefs.push_back(followUp);
+            followUpLines.push_back(lineNumber);
+            continue;
+        }
+
+        if (keyword == "modifier") {
+            ModifierDef modifier;
+            if (!parseModifier(rest, modifier)) {
+                error = "line " + std::to_string(lineNumber) + ": malformed modifier";
+                return false;
+            }
+            modifierDefs.push_back(modifier);
+            modifierLines.push_back(lineNumber);
+            continue;
+        }
+
+        if (keyword == "apply") {
+            ApplyDef apply;
+            if (!parseApply(rest, apply)) {
+                error = "line " + std::to_string(lineNumber) + ": malformed apply";
+                return false;
+            }
+            applyDefs.push_back(apply);
+            applyLines.push_back(lineNumber);
+            continue;
+        }
+
+        if (keyword == "rule") {
+            StatRule rule;
+            if (!parseRule(rest, rule)) {
+                error = "line " + std::to_string(lineNumber) + ": malformed rule";
+                return false;
+            }
+            rules.push_back(rule);
+            ruleLines.push_back(lineNumber);
+            continue;
+        }
+
+        EventDef def;
+        if (keyword != "event" || !parseEvent(rest, def)) {
+            error = "line " + std::to_string(lineNumber) + ": malformed event";
+            return false;
+        }
+        if (def.id < 0 || def.id > EventManager::MAX_EVENT_ID) {
+            error = "line " + std::to_string(lineNumber) + ": event id out of range";
+            return false;
+        }
+        if (def.id > maxId) maxId = def.id;
+        defs.push_back(def);
+        lines.push_back(lineNumber);
+    }
+
+    // Reject duplicates before touching the registry
+    std::vector<uint8_t> seen(static_cast<size_t>(maxId + 1), 0);
+    for (size_t i = 0; i < defs.size(); ++i) {
+        if (seen[defs[i].id] || events.findEvent(defs[i].id)) {
+            error = "line " + std::to_string(lines[i]) + ": duplicate event id " + std::to_string(defs[i].id);
+            return false;
+        }
+        seen[defs[i].id] = 1;
+    }
+    auto known = [&](int id) { return (id >= 0 && id <= maxId && seen[id]) || events.findEvent(id); };
+    for (size_t i = 0; i < rules.size(); ++i) {
+        if (!known(rules[i].eventId)) {
+            error = "line " + std::to_string(ruleLines[i]) + ": rule triggers unknown event " +
+                    std::to_string(rules[i].eventId);
+            return false;
+        }
+    }
+    for (size_t i = 0; i < followUpDefs.size(); ++i) {
+        const FollowUpDef& f = followUpDefs[i];
+        if (!known(f.eventId) || !known(f.followUpId)) {
+            error = "line " + std::to_string(followUpLines[i]) + ": followup names an unknown event";
+            return false;
+        }
+    }
+    auto modifierKnown = [&](const std::string& name, size_t before) {
+        for (size_t i = 0; i < before; ++i) {
+            if (modifierDefs[i].name == name) return true;
+        }
+        return events.findModifier(name) >= 0;
+    };
+    for (size_t i = 0; i < modifierDefs.size(); ++i) {
+        if (modifierKnown(modifierDefs[i].name, i)) {
+            error = "line " + std::to_string(modifierLines[i]) + ": duplicate modifier " + modifierDefs[i].name;
+            return false;
+        }
+    }
+    for (size_t i = 0; i < applyDefs.size(); ++i) {
+        if (!known(applyDefs[i].eventId) || !modifierKnown(applyDefs[i].modifier, modifierDefs.size())) {
+            error = "line " + std::to_string(applyLines[i]) + ": apply names an unknown event or modifier";
+            return false;
+        }
+    }
+    if (events.isFrozen()) {
+        error = "event registry is frozen";
+        return false;
+    }
+
+    events.reserve(defs.size(), maxId);
+    for (const EventDef& def : defs) {
+        events.registerEvent(def.id, def.description, def.priority, def.effect);
+    }
+    for (const StatRule& rule : rules) {
+        events.addRule(rule);
+    }
+    for (const FollowUpDef& f : followUpDefs) {
+        events.addFollowUp(f.eventId, f.followUpId, static_cast<uint32_t>(f.delayDays),
+                           static_cast<uint32_t>(f.periodDays));
+    }
+    for (const ModifierDef& m : modifierDefs) {
+        events.defineModifier(m.name, m.type);
+    }
+    for (const ApplyDef& a : applyDefs) {
+        events.addModifier(a.eventId, events.findModifier(a.modifier));
+    }
+    events.freeze();
+    return true;
+}
+
+}
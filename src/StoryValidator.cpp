@@ -0,0 +1,142 @@
+#include "StoryValidator.h"
+#include <algorithm>
+#include <chrono>
+
+using namespace StoryFormat;
+
+bool StoryDiagnostics::hasErrors() const {
+    return startIndex == NO_INDEX || !danglingChoices.empty() || !unknownNodeRefs.empty() || !sinks.empty();
+}
+
+size_t StoryDiagnostics::getCycleCount() const {
+    return cycleStarts.empty() ? 0 : cycleStarts.size() - 1;
+}
+
+namespace {
+
+// ---------------- Reachability ----------------
+
+void findUnreachable(const NodeStore& store, StoryDiagnostics& out) {
+    const uint32_t count = store.getNodeCount();
+    std::vector<uint8_t> seen(count, 0);
+    std::vector<uint32_t> queue;
+    queue.reserve(count);
+
+    if (out.startIndex != NO_INDEX) {
+        seen[out.startIndex] = 1;
+        queue.push_back(out.startIndex);
+    }
+    for (size_t head = 0; head < queue.size(); ++head) {
+        const NodeRecord& rec = store.getNode(queue[head]);
+        for (uint32_t c = rec.firstChoice; c < rec.firstChoice + rec.choiceCount; ++c) {
+            uint32_t target = store.getChoice(c).targetIndex;
+            if (!seen[target]) {
+                seen[target] = 1;
+                queue.push_back(target);
+            }
+        }
+    }
+
+    for (uint32_t n = 0; n < count; ++n) {
+        if (!seen[n]) out.unreachable.push_back(n);
+    }
+}
+
+// ---------------- Tarjan SCC ----------------
+
+void findCycles(const NodeStore& store, StoryDiagnostics& out) {
+    const uint32_t count = store.getNodeCount();
+    std::vector<uint32_t> order(count, NO_INDEX);   // discovery index
+    std::vector<uint32_t> low(count, 0);
+    std::vector<uint8_t> onStack(count, 0);
+    std::vector<uint32_t> stack;
+
+    struct Frame {
+        uint32_t node;
+        uint32_t nextChoice;
+    };
+    std::vector<Frame> calls;
+    uint32_t counter = 0;
+
+    for (uint32_t root = 0; root < count; ++root) {
+        if (order[root] != NO_INDEX) continue;
+
+        calls.push_back({root, store.getNode(root).firstChoice});
+        order[root] = low[root] = counter++;
+        stack.push_back(root);
+        onStack[root] = 1;
+
+        while (!calls.empty()) {
+            Frame& frame = calls.back();
+            const uint32_t v = frame.node;
+            const NodeRecord& rec = store.getNode(v);
+
+            if (frame.nextChoice < rec.firstChoice + rec.choiceCount) {
+                uint32_t w = store.getChoice(frame.nextChoice++).targetIndex;
+                if (order[w] == NO_INDEX) {
+                    order[w] = low[w] = counter++;
+                    stack.push_back(w);
+                    onStack[w] = 1;
+                    calls.push_back({w, store.getNode(w).firstChoice});
+                } else if (onStack[w]) {
+                    low[v] = std::min(low[v], order[w]);
+                }
+                continue;
+            }
+
+            // All successors done: v is a root if nothing below reaches higher
+            if (low[v] == order[v]) {
+                size_t begin = stack.size();
+                do {
+                    --begin;
+                } while (stack[begin] != v);
+
+                bool cyclic = stack.size() - begin > 1;
+                if (!cyclic) {
+                    for (uint32_t c = rec.firstChoice; c < rec.firstChoice + rec.choiceCount; ++c) {
+                        if (store.getChoice(c).targetIndex == v) cyclic = true;
+                    }
+                }
+                if (cyclic) {
+                    if (out.cycleStarts.empty()) out.cycleStarts.push_back(0);
+                    out.cycleNodes.insert(out.cycleNodes.end(), stack.begin() + begin, stack.end());
+                    out.cycleStarts.push_back(static_cast<uint32_t>(out.cycleNodes.size()));
+                }
+                for (size_t i = begin; i < stack.size(); ++i) onStack[stack[i]] = 0;
+                stack.resize(begin);
+            }
+
+            calls.pop_back();
+            if (!calls.empty()) {
+                uint32_t parent = calls.back().node;
+                low[parent] = std::min(low[parent], low[v]);
+            }
+        }
+    }
+}
+
+}
+
+namespace StoryValidator {
+
+StoryDiagnostics validate(const NodeStore& store, int startId) {
+    auto start = std::chrono::steady_clock::now();
+
+    StoryDiagnostics out;
+    out.startIndex = store.findIndex(startId);
+    out.danglingChoices = store.getDanglingChoices();
+    out.unknownNodeRefs = store.getUnknownNodeRefs();
+
+    for (uint32_t n = 0; n < store.getNodeCount(); ++n) {
+        const NodeRecord& rec = store.getNode(n);
+        if (rec.choiceCount == 0 && !(rec.flags & NODE_ENDING)) out.sinks.push_back(n);
+    }
+
+    findUnreachable(store, out);
+    findCycles(store, out);
+
+    out.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return out;
+}
+
+}
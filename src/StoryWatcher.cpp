@@ -0,0 +1,235 @@
+#include "StoryWatcher.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+// ============================================================
+// StoryWatcher Implementation
+// ============================================================
+
+namespace {
+
+struct FileStamp {
+    std::filesystem::file_time_type time;
+    uintmax_t size = 0;
+    bool exists = false;
+
+    bool operator==(const FileStamp& other) const {
+        return exists == other.exists && time == other.time && size == other.size;
+    }
+    bool operator!=(const FileStamp& other) const { return !(*this == other); }
+};
+
+FileStamp stampOf(const std::string& path) {
+    FileStamp stamp;
+    std::error_code ec;
+    stamp.time = std::filesystem::last_write_time(path, ec);
+    if (ec) return stamp;
+    stamp.size = std::filesystem::file_size(path, ec);
+    stamp.exists = !ec;
+    return stamp;
+}
+
+bool readFile(const std::string& path, std::string& out) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) return false;
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    out = contents.str();
+    return true;
+}
+
+uint64_t hashBlock(std::string_view s) {
+    // FNV-1a, 64-bit
+    uint64_t h = 14695981039346656037ull;
+    for (unsigned char c : s) {
+        h ^= c;
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+// A "node <id>" line starts a block
+bool isNodeLine(std::string_view line, int& id) {
+    size_t i = line.find_first_not_of(" \t");
+    if (i == std::string_view::npos || line.compare(i, 4, "node") != 0) return false;
+    i += 4;
+    if (i >= line.size() || (line[i] != ' ' && line[i] != '\t')) return false;
+    id = std::atoi(std::string(line.substr(i)).c_str());
+    return true;
+}
+
+struct Block {
+    int id;
+    int firstLine;
+    std::string_view text;
+};
+
+std::vector<Block> splitBlocks(const std::string& contents) {
+    std::vector<Block> blocks;
+    size_t pos = 0;
+    int lineNumber = 0;
+    while (pos < contents.size()) {
+        size_t end = contents.find('\n', pos);
+        if (end == std::string::npos) end = contents.size();
+        ++lineNumber;
+
+        int id;
+        if (isNodeLine(std::string_view(contents).substr(pos, end - pos), id)) {
+            if (!blocks.empty()) {
+                Block& last = blocks.back();
+                last.text = std::string_view(last.text.data(), contents.data() + pos - last.text.data());
+            }
+            blocks.push_back({id, lineNumber, std::string_view(contents.data() + pos, 0)});
+        }
+        pos = end + 1;
+    }
+    if (!blocks.empty()) {
+        Block& last = blocks.back();
+        last.text = std::string_view(last.text.data(), contents.data() + contents.size() - last.text.data());
+    }
+    return blocks;
+}
+
+}
+
+StoryWatcher::StoryWatcher(const std::string& path, int pollMs, int debounceMs)
+    : path(path), pollMs(pollMs), debounceMs(debounceMs), running(false), hasPending(false) {}
+
+StoryWatcher::~StoryWatcher() {
+    stop();
+}
+
+void StoryWatcher::start() {
+    if (running) return;
+    running = true;
+    worker = std::thread(&StoryWatcher::run, this);
+}
+
+void StoryWatcher::stop() {
+    running = false;
+    if (worker.joinable()) worker.join();
+}
+
+void StoryWatcher::run() {
+    FileStamp last = stampOf(path);
+    std::string contents;
+    if (last.exists && readFile(path, contents)) scan(contents, true);
+
+    while (running) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(pollMs));
+
+        FileStamp current = stampOf(path);
+        if (!current.exists || current == last) continue;
+
+        // Debounce: editors often write a file in several steps
+        for (;;) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(debounceMs));
+            if (!running) return;
+            FileStamp settled = stampOf(path);
+            if (settled == current) break;
+            current = settled;
+        }
+        last = current;
+
+        if (readFile(path, contents)) scan(contents, false);
+    }
+}
+
+void StoryWatcher::scan(const std::string& contents, bool baseline) {
+    std::vector<Block> blocks = splitBlocks(contents);
+    std::unordered_map<int, uint64_t> hashes;
+    hashes.reserve(blocks.size());
+
+    StoryPatch patch;
+    for (const Block& block : blocks) {
+        uint64_t hash = hashBlock(block.text);
+        hashes[block.id] = hash;
+        if (baseline) continue;
+
+        auto previous = blockHashes.find(block.id);
+        if (previous != blockHashes.end() && previous->second == hash) continue;
+
+        // Re-parse only this block
+        std::istringstream in{std::string(block.text)};
+        std::string error;
+        bool ok = StoryParser::parseNodes(in, [&patch](const StoryNodeDef& node) {
+            patch.nodes.push_back(node);
+        }, error, block.firstLine);
+        if (!ok) {
+            // Keep the old baseline so the block is retried on the next save
+            StoryPatch failed;
+            failed.error = error;
+            publish(failed);
+            return;
+        }
+    }
+
+    if (!baseline) {
+        for (const auto& entry : blockHashes) {
+            if (hashes.find(entry.first) == hashes.end()) patch.removed.push_back(entry.first);
+        }
+    }
+    blockHashes.swap(hashes);
+
+    if (!patch.empty()) publish(patch);
+}
+
+void StoryWatcher::publish(StoryPatch& patch) {
+    std::lock_guard<std::mutex> lock(pendingMutex);
+    if (!hasPending) {
+        pending = std::move(patch);
+        hasPending = true;
+        return;
+    }
+
+    // Merge into the patch the frame loop has not taken yet
+    pending.error = patch.error;
+    for (StoryNodeDef& node : patch.nodes) {
+        pending.removed.erase(std::remove(pending.removed.begin(), pending.removed.end(), node.id),
+                              pending.removed.end());
+        auto existing = std::find_if(pending.nodes.begin(), pending.nodes.end(),
+                                     [&node](const StoryNodeDef& n) { return n.id == node.id; });
+        if (existing != pending.nodes.end()) *existing = std::move(node);
+        else pending.nodes.push_back(std::move(node));
+    }
+    for (int id : patch.removed) {
+        pending.nodes.erase(std::remove_if(pending.nodes.begin(), pending.nodes.end(),
+                                           [id](const StoryNodeDef& n) { return n.id == id; }),
+                            pending.nodes.end());
+        if (std::find(pending.removed.begin(), pending.removed.end(), id) == pending.removed.end()) {
+            pending.removed.push_back(id);
+        }
+    }
+}
+
+bool StoryWatcher::takePatch(StoryPatch& out) {
+    std::unique_lock<std::mutex> lock(pendingMutex, std::try_to_lock);
+    if (!lock.owns_lock() || !hasPending) return false;
+
+    out = std::move(pending);
+    pending = StoryPatch();
+    hasPending = false;
+    return true;
+}
+
+bool StoryWatcher::apply(DecisionTree& tree, const StoryPatch& patch) {
+    // A parse error only blocks the broken edit; earlier merged edits still apply
+    if (patch.nodes.empty() && patch.removed.empty()) return false;
+
+    const int current = tree.getCurrentNodeId();
+    tree.editStory();
+    for (const StoryNodeDef& node : patch.nodes) {
+        StoryParser::addNode(tree, node);
+    }
+    for (int id : patch.removed) {
+        if (id != current) tree.removeNode(id);
+    }
+
+    // Re-resolves the current node ID to its new index
+    tree.finalize();
+    return true;
+}
@@ -0,0 +1,76 @@
+#include "StringPool.h"
+
+// ============================================================
+// StringPool Implementation (open addressing, linear probing)
+// ============================================================
+
+StringPool::StringPool() : usedSlots(0) {}
+
+uint32_t StringPool::hashOf(std::string_view s) {
+    // FNV-1a
+    uint32_t h = 2166136261u;
+    for (unsigned char c : s) {
+        h ^= c;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+uint32_t StringPool::intern(std::string_view s) {
+    if (s.empty()) return 0;
+    if ((usedSlots + 1) * 2 > slots.size()) grow();
+
+    const uint32_t h = hashOf(s);
+    const size_t mask = slots.size() - 1;
+    size_t i = h & mask;
+    while (slots[i].used) {
+        const Slot& slot = slots[i];
+        if (slot.hash == h && slot.length == s.size() && get(slot.offset, slot.length) == s) {
+            return slot.offset;
+        }
+        i = (i + 1) & mask;
+    }
+
+    uint32_t offset = static_cast<uint32_t>(arena.size());
+    arena.append(s.data(), s.size());
+    slots[i] = {offset, static_cast<uint32_t>(s.size()), h, true};
+    ++usedSlots;
+    return offset;
+}
+
+void StringPool::grow() {
+    std::vector<Slot> old;
+    old.swap(slots);
+    slots.assign(old.empty() ? 64 : old.size() * 2, Slot{0, 0, 0, false});
+
+    const size_t mask = slots.size() - 1;
+    for (const Slot& slot : old) {
+        if (!slot.used) continue;
+        size_t i = slot.hash & mask;
+        while (slots[i].used) i = (i + 1) & mask;
+        slots[i] = slot;
+    }
+}
+
+std::string_view StringPool::get(uint32_t offset, uint32_t length) const {
+    return std::string_view(arena.data() + offset, length);
+}
+
+const char* StringPool::data() const {
+    return arena.data();
+}
+
+size_t StringPool::size() const {
+    return arena.size();
+}
+
+void StringPool::adopt(std::string blob) {
+    clear();
+    arena.swap(blob);
+}
+
+void StringPool::clear() {
+    arena.clear();
+    slots.clear();
+    usedSlots = 0;
+}
@@ -0,0 +1,191 @@
+#include "TimerWheel.h"
+
+// ============================================================
+// TimerWheel Implementation
+// ============================================================
+
+namespace {
+    const int OVERFLOW_LIST = TimerWheel::LEVELS * TimerWheel::SLOTS;
+    const uint64_t SLOT_MASK = TimerWheel::SLOTS - 1;
+}
+
+TimerWheel::TimerWheel() : current(0), count(0) {
+    for (uint32_t& head : heads) head = NONE;
+    for (uint64_t& bits : occupied) bits = 0;
+}
+
+// ---------------- Lists ----------------
+
+void TimerWheel::link(uint32_t index, int list) {
+    Timer& timer = timers[index];
+    timer.list = static_cast<uint16_t>(list);
+    timer.prev = NONE;
+    timer.next = heads[list];
+    if (timer.next != NONE) timers[timer.next].prev = index;
+    heads[list] = index;
+    if (list < OVERFLOW_LIST) occupied[list / SLOTS] |= 1ull << (list % SLOTS);
+}
+
+void TimerWheel::unlink(uint32_t index) {
+    Timer& timer = timers[index];
+    if (timer.prev != NONE) timers[timer.prev].next = timer.next;
+    else heads[timer.list] = timer.next;
+    if (timer.next != NONE) timers[timer.next].prev = timer.prev;
+
+    if (heads[timer.list] == NONE && timer.list < OVERFLOW_LIST) {
+        occupied[timer.list / SLOTS] &= ~(1ull << (timer.list % SLOTS));
+    }
+    timer.prev = timer.next = NONE;
+}
+
+// Level by distance from now; the slot is the expiry's digit at that level
+void TimerWheel::place(uint32_t index) {
+    const uint64_t expires = timers[index].expires;
+    const uint64_t delta = expires - current;
+    for (int level = 0; level < LEVELS; ++level) {
+        const int shift = SLOT_BITS * level;
+        if (delta < (1ull << (shift + SLOT_BITS))) {
+            link(index, level * SLOTS + static_cast<int>((expires >> shift) & SLOT_MASK));
+            return;
+        }
+    }
+    link(index, OVERFLOW_LIST);
+}
+
+// ---------------- Scheduling ----------------
+
+TimerId TimerWheel::schedule(uint64_t delay, uint64_t period, int eventId) {
+    uint32_t index;
+    if (!freeTimers.empty()) {
+        index = freeTimers.back();
+        freeTimers.pop_back();
+    } else {
+        index = static_cast<uint32_t>(timers.size());
+        timers.emplace_back();
+    }
+
+    Timer& timer = timers[index];
+    timer.expires = current + (delay == 0 ? 1 : delay);
+    timer.period = period;
+    timer.eventId = eventId;
+    timer.active = true;
+    place(index);
+    ++count;
+
+    TimerId id;
+    id.index = index;
+    id.generation = timer.generation;
+    return id;
+}
+
+bool TimerWheel::cancel(TimerId id) {
+    if (id.index >= timers.size()) return false;
+    Timer& timer = timers[id.index];
+    if (!timer.active || timer.generation != id.generation) return false;
+
+    unlink(id.index);
+    timer.active = false;
+    timer.generation++;
+    freeTimers.push_back(id.index);
+    --count;
+    return true;
+}
+
+// ---------------- Expiry ----------------
+
+// Re-place every timer of one slot; each lands at least one level lower
+void TimerWheel::cascade(int level) {
+    const int shift = SLOT_BITS * level;
+    const int list = level * SLOTS + static_cast<int>((current >> shift) & SLOT_MASK);
+    uint32_t index = heads[list];
+    heads[list] = NONE;
+    occupied[level] &= ~(1ull << (list % SLOTS));
+    while (index != NONE) {
+        uint32_t next = timers[index].next;
+        place(index);
+        index = next;
+    }
+}
+
+void TimerWheel::advance(uint64_t now, std::vector<int>& expired) {
+    if (count == 0) {
+        if (now > current) current = now;
+        return;
+    }
+
+    while (current < now) {
+        // Nothing due at the bottom level: skip to the end of this lap
+        if (occupied[0] == 0 && (current & SLOT_MASK) != SLOT_MASK) {
+            current = (current | SLOT_MASK) < now ? (current | SLOT_MASK) : now;
+            continue;
+        }
+
+        ++current;
+
+        // Coarser levels first, so their timers can still drop to level 0
+        if ((current & SLOT_MASK) == 0) {
+            int top = 1;
+            while (top < LEVELS - 1 && ((current >> (SLOT_BITS * top)) & SLOT_MASK) == 0) ++top;
+            if (top == LEVELS - 1 && ((current >> (SLOT_BITS * top)) & SLOT_MASK) == 0) {
+                uint32_t index = heads[OVERFLOW_LIST];
+                heads[OVERFLOW_LIST] = NONE;
+                while (index != NONE) {
+                    uint32_t next = timers[index].next;
+                    place(index);
+                    index = next;
+                }
+            }
+            for (int level = top; level >= 1; --level) cascade(level);
+        }
+
+        // Everything in the current bottom slot expires now
+        const int list = static_cast<int>(current & SLOT_MASK);
+        while (heads[list] != NONE) {
+            uint32_t index = heads[list];
+            unlink(index);
+            Timer& timer = timers[index];
+            expired.push_back(timer.eventId);
+
+            if (timer.period > 0) {
+                timer.expires = current + timer.period;
+                place(index);
+            } else {
+                timer.active = false;
+                timer.generation++;
+                freeTimers.push_back(index);
+                --count;
+            }
+        }
+    }
+}
+
+// ---------------- Queries ----------------
+
+uint64_t TimerWheel::getTime() const {
+    return current;
+}
+
+size_t TimerWheel::size() const {
+    return count;
+}
+
+void TimerWheel::getPending(std::vector<Pending>& out) const {
+    out.clear();
+    for (const Timer& timer : timers) {
+        if (timer.active) out.push_back({ timer.expires, timer.period, timer.eventId });
+    }
+}
+
+void TimerWheel::clear(uint64_t now) {
+    for (uint32_t index = 0; index < timers.size(); ++index) {
+        if (timers[index].active) {
+            timers[index].active = false;
+            timers[index].generation++;
+            freeTimers.push_back(index);
+        }
+    }
+    for (uint32_t& head : heads) head = NONE;
+    for (uint64_t& bits : occupied) bits = 0;
+    current = now;
+    count = 0;
+}
@@ -1,5 +1,6 @@
 #include "../include/UI.h"
 #include <imgui.h>
+#include <cstdio>
 #include <iostream>
 #include <GLFW/glfw3.h>   // FIRST
 
@@ -14,8 +15,9 @@ namespace UIManager {
 
 // Main render loop (orchestrates all UI elements)
 void render(GameState& state, DecisionTree& story, std::vector<Event>& eventLog, 
-            int& selectedChoice, GameStateStack& history, ActionQueue& actionQueue) {
-    displayStatsPanel(state.stats, state.day, state.packSize, "Winter");
+            int& selectedChoice, GameStateStack& history, ActionQueue& actionQueue,
+            const StatHistory* statHistory) {
+    displayStatsPanel(state.stats, state.day, state.packSize, "Winter", statHistory);
     displayNodeGUI(story.getCurrentNode(), selectedChoice);
     showInventoryGUI(state.inventory, state.stats);
     displayEventLog(eventLog);
@@ -34,7 +36,8 @@ void checkEscapeKey(GLFWwindow* window) {
 }
 
 // Stats panel - LEFT SIDE, RESPONSIVE
-void displayStatsPanel(const Stats& stats, int day, int packSize, const std::string& weather) {
+void displayStatsPanel(const Stats& stats, int day, int packSize, std::string_view weather,
+                       const StatHistory* statHistory) {
     ImGuiIO& io = ImGui::GetIO();
     float windowWidth = io.DisplaySize.x;
     float windowHeight = io.DisplaySize.y;
@@ -51,7 +54,7 @@ void displayStatsPanel(const Stats& stats, int day, int packSize, const std::str
     // Header info
     ImGui::Text("Day: %d", day);
     ImGui::Text("Pack Size: %d", packSize);
-    ImGui::Text("Weather: %s", weather.c_str());
+    ImGui::Text("Weather: %.*s", static_cast<int>(weather.size()), weather.data());
     ImGui::Separator();
     ImGui::Spacing();
     
@@ -106,6 +109,58 @@ void displayStatsPanel(const Stats& stats, int day, int packSize, const std::str
     ImGui::Separator();
     ImGui::Text("Experience Points: %d", stats.getXP());
     ImGui::Spacing();
+
+    // Trends: at most PLOT_POINTS buckets per stat, however long the game ran
+    if (statHistory && ImGui::CollapsingHeader("Trends")) {
+        static int perTick = 0;
+        static std::string exportStatus;
+        ImGui::RadioButton("Per day", &perTick, 0);
+        ImGui::SameLine();
+        ImGui::RadioButton("Per tick", &perTick, 1);
+        const StatSeries& series = perTick ? statHistory->ticks : statHistory->days;
+
+        static const char* const labels[STAT_COUNT] = {
+            "Health", "Hunger", "Stamina", "Pack", "Morale", "Strength", "XP"
+        };
+        float avg[StatSeries::PLOT_POINTS];
+        float low[StatSeries::PLOT_POINTS];
+        float high[StatSeries::PLOT_POINTS];
+        for (int s = 0; s < STAT_COUNT; ++s) {
+            const StatId stat = static_cast<StatId>(s);
+            int points = series.plot(stat, avg, low, high);
+            if (points == 0) continue;
+
+            float lowest = low[0], highest = high[0];
+            for (int i = 1; i < points; ++i) {
+                if (low[i] < lowest) lowest = low[i];
+                if (high[i] > highest) highest = high[i];
+            }
+            char overlay[64];
+            std::snprintf(overlay, sizeof(overlay), "%s  %.0f - %.0f", labels[s], lowest, highest);
+
+            // XP is unbounded, so it scales to its own range
+            const bool bounded = stat != StatId::XP;
+            ImGui::PushID(s);
+            ImGui::PlotLines("##trend", avg, points, 0, overlay,
+                             bounded ? 0.0f : lowest, bounded ? 100.0f : highest, ImVec2(-1, 40));
+            ImGui::PopID();
+        }
+        ImGui::Text("%llu samples", static_cast<unsigned long long>(series.getSampleCount()));
+
+        if (ImGui::Button("Export history", ImVec2(-1, 25))) {
+            std::string error;
+            bool ok = statHistory->days.exportCsv("wolf_days.csv", error) &&
+                      statHistory->ticks.exportCsv("wolf_ticks.csv", error) &&
+                      statHistory->days.exportBinary("wolf_days.wsh", error) &&
+                      statHistory->ticks.exportBinary("wolf_ticks.wsh", error);
+            exportStatus = ok ? "Saved wolf_days/wolf_ticks .csv and .wsh" : error;
+        }
+        if (ImGui::IsItemHovered()) {
+            ImGui::SetTooltip("CSV and binary (.wsh) files for balance analysis");
+        }
+        if (!exportStatus.empty()) ImGui::TextWrapped("%s", exportStatus.c_str());
+        ImGui::Spacing();
+    }
     
     // Warning messages for critical stats
     ImGui::Separator();
@@ -129,8 +184,8 @@ void displayStatsPanel(const Stats& stats, int day, int packSize, const std::str
 }
 
 // Story node panel - CENTER TOP, RESPONSIVE
-void displayNodeGUI(const Node* node, int& selectedChoice) {
-    if (!node) return;
+void displayNodeGUI(const Node& node, int& selectedChoice) {
+    if (!node.isValid()) return;
 
     ImGuiIO& io = ImGui::GetIO();
     float windowWidth = io.DisplaySize.x;
@@ -149,31 +204,37 @@ void displayNodeGUI(const Node* node, int& selectedChoice) {
     
     // Story text with proper wrapping
     ImGui::PushTextWrapPos(ImGui::GetCursorPos().x + centerColWidth - 30);
-    ImGui::TextWrapped("%s", node->getText().c_str());
+    std::string_view text = node.getText();
+    ImGui::TextWrapped("%.*s", static_cast<int>(text.size()), text.data());
     ImGui::PopTextWrapPos();
     
     ImGui::Spacing();
     ImGui::Separator();
     ImGui::Spacing();
 
-    // Choice buttons - dynamically sized
-    const auto& choices = node->getChoices();
+    // Choice buttons - dynamically sized (labels built on the stack)
     float buttonWidth = centerColWidth - 20;
-    for (size_t i = 0; i < choices.size(); ++i) {
-        std::string buttonLabel = std::string(1, 'A' + i) + ". " + choices[i].first;
-        if (ImGui::Button(buttonLabel.c_str(), ImVec2(buttonWidth, 50))) {
-            selectedChoice = static_cast<int>(i);
+    int i = 0;
+    for (const Choice& choice : node.getChoicesWithEffects()) {
+        std::string_view choiceText = choice.getText();
+        char buttonLabel[512];
+        std::snprintf(buttonLabel, sizeof(buttonLabel), "%c. %.*s", 'A' + i,
+                      static_cast<int>(choiceText.size()), choiceText.data());
+        if (ImGui::Button(buttonLabel, ImVec2(buttonWidth, 50))) {
+            selectedChoice = i;
         }
         ImGui::Spacing();
+        ++i;
     }
     
-    if (node->isEndingNode()) {
+    if (node.isEndingNode()) {
         ImGui::Spacing();
         ImGui::Separator();
         ImGui::Spacing();
         ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(8, 8));
         ImGui::TextColored(ImVec4(1.0f, 0.8f, 0.0f, 1.0f), "★ ENDING REACHED ★");
-        ImGui::TextWrapped("%s", node->getEndingType().c_str());
+        std::string_view endingType = node.getEndingType();
+        ImGui::TextWrapped("%.*s", static_cast<int>(endingType.size()), endingType.data());
         ImGui::PopStyleVar();
     }
 
@@ -270,10 +331,10 @@ void showInventoryGUI(Inventory* inventory, Stats& stats) {
 }
 
 // Single event window (floating) - kept for compatibility
-void displayEventGUI(const std::string& text) {
+void displayEventGUI(std::string_view text) {
     ImGui::SetNextWindowSize(ImVec2(600, 80), ImGuiCond_Once);
     ImGui::Begin("Event", nullptr, ImGuiWindowFlags_NoCollapse);
-    ImGui::TextWrapped("%s", text.c_str());
+    ImGui::TextWrapped("%.*s", static_cast<int>(text.size()), text.data());
     ImGui::End();
 }
 
@@ -306,8 +367,8 @@ void displayEventLog(const std::vector<Event>& events) {
     int maxEvents = static_cast<int>(scrollHeight / 25);  // Estimate events that fit
     int startIdx = events.size() > maxEvents ? events.size() - maxEvents : 0;
     for (int i = startIdx; i < static_cast<int>(events.size()); ++i) {
-        std::string eventText = "• " + events[i].getDescription();
-        ImGui::TextWrapped("%s", eventText.c_str());
+        std::string_view description = events[i].getDescription();
+        ImGui::TextWrapped("• %.*s", static_cast<int>(description.size()), description.data());
         ImGui::Spacing();
     }
 
@@ -347,8 +408,8 @@ void displayActionControls(GameStateStack& history, ActionQueue& actionQueue,
     // State history information
     int historySize = history.getSize();
     ImGui::Text("Game State History:");
-    ImGui::Text("  %d / 5 saves available", historySize);
-    ImGui::ProgressBar(historySize / 5.0f, ImVec2(-1, 22));
+    ImGui::Text("  %d steps saved (%.1f KB)", historySize, history.getMemoryUsage() / 1024.0);
+    ImGui::ProgressBar(historySize / static_cast<float>(GameStateStack::MAX_SIZE), ImVec2(-1, 22));
     ImGui::Spacing();
     
     // Action queue information
@@ -473,7 +534,7 @@ bool displayWelcomeScreen(bool& startGame) {
 }
 
 // Ending screen - CENTERED, RESPONSIVE
-void displayEndingGUI(const std::string& text) {
+void displayEndingGUI(std::string_view text) {
     ImGuiIO& io = ImGui::GetIO();
     float windowWidth = io.DisplaySize.x;
     float windowHeight = io.DisplaySize.y;
@@ -497,7 +558,7 @@ void displayEndingGUI(const std::string& text) {
     ImGui::Spacing();
     
     ImGui::PushTextWrapPos(ImGui::GetCursorPos().x + endingWidth - 40);
-    ImGui::TextWrapped("%s", text.c_str());
+    ImGui::TextWrapped("%.*s", static_cast<int>(text.size()), text.data());
     ImGui::PopTextWrapPos();
     
     ImGui::Spacing();
@@ -1,14 +1,17 @@
 #include "../include/DecisionTree.h"
 #include "../include/EventManager.h"
+#include "../include/EventTrace.h"
 #include "../include/Stats.h"
 #include "../include/UI.h"
 #include "../include/Inventory.h"
 #include "../include/GameState.h"
 #include "../include/ActionQueue.h"
+#include "../include/GameSession.h"
+#include "../include/StoryWatcher.h"
 
 #include <iostream>
+#include <string_view>
 #include <vector>
-#include <random>
 #include <GLFW/glfw3.h>
 #include <imgui.h>
 #include "imgui_impl_glfw.h"
@@ -21,6 +24,9 @@
 // - Integrated UI undo controls with backend
 // - Confirmation messages for all actions
 // - Proper state restoration with UI sync
+// - Gameplay resolved by the headless GameSession engine
+// - Story source hot-reloaded while the game runs
+// - Every event is recorded to wolf.trace (read it with wolf_trace)
 // ============================================================
 
 // Notification system for user feedback
@@ -69,62 +75,28 @@ void updateAndRenderNotifications(float deltaTime) {
     ImGui::PopStyleVar();
 }
 
-// ---------------- Initialize Events ----------------
-void initializeEvents(EventManager& eventManager) {
-    eventManager.registerEvent(1, "The cold wind bites at your fur. Your body shivers.", Priority::MEDIUM, StatEffect(0, 5, -10, 0));
-    eventManager.registerEvent(2, "The icy air drains your energy as you track the prey.", Priority::MEDIUM, StatEffect(0, 5, -15, 0));
-    eventManager.registerEvent(3, "Your hunger grows as you wait in the snow.", Priority::MEDIUM, StatEffect(0, 10, -5, 0));
-    eventManager.registerEvent(4, "The ice cracks dangerously beneath you!", Priority::HIGH, StatEffect(-20, 0, -20, 0));
-    eventManager.registerEvent(5, "The long detour exhausts you further.", Priority::MEDIUM, StatEffect(0, 10, -15, 0));
-    eventManager.registerEvent(6, "Tension rises as the strange wolves approach.", Priority::MEDIUM, StatEffect(0, 5, -10, 5));
-    eventManager.registerEvent(7, "The encounter leaves you wary and alert.", Priority::MEDIUM, StatEffect(0, 5, -10, 0));
-    eventManager.registerEvent(8, "You feast on fresh venison! Your strength returns.", Priority::HIGH, StatEffect(30, -50, 40, 0));
-    eventManager.registerEvent(9, "Caution preserves your energy.", Priority::LOW, StatEffect(0, 5, 5, 0));
-    eventManager.registerEvent(10, "Ancient knowledge fills you with confidence.", Priority::LOW, StatEffect(10, 0, 0, 10));
-}
-
-// ---------------- Random Events ----------------
-void generateRandomEvent(EventManager& eventManager, Inventory* inventory) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(1, 100);
-    int roll = dis(gen);
-
-    if (roll <= 15) {
-        eventManager.registerEvent(100, "You found some winter berries hidden under snow!", Priority::LOW, StatEffect(0, -10, 0, 0));
-        eventManager.triggerEvent(100);
-        inventory->addItem("Winter Berries", "FOOD", 10, 1);
-        addNotification("Found: Winter Berries!", ImVec4(0.5f, 1.0f, 0.5f, 1.0f));
-    }
-    else if (roll <= 25 && !inventory->isFull()) {
-        inventory->addItem("Healing Herbs", "HERB", 20, 1);
-        addNotification("Found: Healing Herbs!", ImVec4(0.5f, 1.0f, 0.5f, 1.0f));
-    }
-    else if (roll <= 35) {
-        eventManager.registerEvent(101, "A harsh wind chills you to the bone.", Priority::MEDIUM, StatEffect(0, 5, -15, 0));
-        eventManager.triggerEvent(101);
-        addNotification("A harsh wind strikes!", ImVec4(1.0f, 0.5f, 0.5f, 1.0f));
-    }
-    else if (roll <= 40 && !inventory->isFull()) {
-        inventory->addItem("Dried Meat", "FOOD", 25, 1);
-        addNotification("Found: Dried Meat!", ImVec4(0.5f, 1.0f, 0.5f, 1.0f));
+// Present session feedback as colored notifications
+void notifySession(SessionMessage message, std::string_view text) {
+    ImVec4 color;
+    switch (message) {
+        case SessionMessage::ChoiceMade:     color = ImVec4(0.8f, 0.8f, 1.0f, 1.0f); break;
+        case SessionMessage::ItemFound:      color = ImVec4(0.5f, 1.0f, 0.5f, 1.0f); break;
+        case SessionMessage::Hazard:         color = ImVec4(1.0f, 0.5f, 0.5f, 1.0f); break;
+        case SessionMessage::EventApplied:   color = ImVec4(1.0f, 0.8f, 0.0f, 1.0f); break;
+        case SessionMessage::StateRestored:  color = ImVec4(0.5f, 0.5f, 1.0f, 1.0f); break;
+        case SessionMessage::NothingToUndo:  color = ImVec4(1.0f, 0.5f, 0.0f, 1.0f); break;
+        case SessionMessage::HistoryCleared: color = ImVec4(1.0f, 1.0f, 0.0f, 1.0f); break;
+        default:                             color = ImVec4(1.0f, 1.0f, 1.0f, 1.0f); break;
     }
+    addNotification(std::string(text), color);
 }
 
 // ---------------- Game Loop ----------------
-void gameLoop(
-    GLFWwindow* window,
-    DecisionTree& tree,
-    EventManager& em,
-    GameState& gameState,
-    GameStateStack& stateHistory,
-    ActionQueue& actionQueue,
-    std::vector<Event>& eventLog,
-    float deltaTime
-) {
+// Rendering and input only; gameplay is resolved by GameSession
+void gameLoop(GLFWwindow* window, GameSession& session, float deltaTime) {
     int selectedChoice = -1;
-    const Node* node = tree.getCurrentNode();
-    if (!node) return;
+    DecisionTree& tree = session.getTree();
+    if (!tree.getCurrentNode().isValid()) return;
 
     // Check for ESC key to close the game
     UIManager::checkEscapeKey(window);
@@ -133,103 +105,36 @@ void gameLoop(
     bool undoRequested = false;
     bool clearHistoryRequested = false;
     
-    UIManager::render(gameState, tree, eventLog, selectedChoice, stateHistory, actionQueue);
+    UIManager::render(session.getState(), tree, session.getEventLog(), selectedChoice,
+                      session.getHistory(), session.getActions(), &session.getStatHistory());
     
     // Handle undo controls from UI
-    UIManager::displayActionControls(stateHistory, actionQueue, undoRequested, clearHistoryRequested);
+    UIManager::displayActionControls(session.getHistory(), session.getActions(), undoRequested, clearHistoryRequested);
     
     // Handle undo request (from button or U key)
     if (undoRequested || ImGui::IsKeyPressed(ImGuiKey_U)) {
-        GameState previousState;
-        if (stateHistory.undo(previousState)) {
-            // Restore complete game state
-            gameState = previousState;
-            tree.setCurrentNode(gameState.currentNodeId);
-            
-            addNotification("⟲ Restored previous state", ImVec4(0.5f, 0.5f, 1.0f, 1.0f));
-            std::cout << "UNDO: Restored to Node " << gameState.currentNodeId 
-                      << " (Day " << gameState.day << ")" << std::endl;
-        } else {
-            addNotification("Cannot undo - no history!", ImVec4(1.0f, 0.5f, 0.0f, 1.0f));
+        if (session.undo()) {
+            selectedChoice = -1;
         }
     }
     
     // Handle clear history request
     if (clearHistoryRequested) {
-        stateHistory.clear();
-        actionQueue.clear();
-        addNotification("History cleared!", ImVec4(1.0f, 1.0f, 0.0f, 1.0f));
-        std::cout << "Cleared all undo history" << std::endl;
+        session.clearHistory();
     }
 
     // Handle choice selection
     if (selectedChoice != -1) {
-        // Save current state for undo BEFORE making changes
-        stateHistory.push(node->getId(), gameState.stats, gameState.inventory, gameState.day, gameState.packSize);
-        
-        // Get choice with effects
-        const auto& choices = node->getChoicesWithEffects();
-        if (selectedChoice >= 0 && selectedChoice < static_cast<int>(choices.size())) {
-            const Choice& choice = choices[selectedChoice];
-            
-            // Apply choice effects using Command pattern
-            for (const auto& effect : choice.effects) {
-                Command* cmd = new StatChangeCommand(&gameState.stats, effect, choice.text);
-                actionQueue.executeAndTrack(cmd, "Choice Effect", choice.text);
-            }
-            
-            // Navigate to next node
-            tree.makeChoice(selectedChoice);
-            gameState.currentNodeId = tree.getCurrentNode()->getId();
-            
-            // Visual feedback
-            addNotification("Choice made: " + choice.text.substr(0, 40) + "...", 
-                          ImVec4(0.8f, 0.8f, 1.0f, 1.0f));
-            
-            // Advance day and apply passive effects
-            gameState.day++;
-            gameState.stats.setHunger(gameState.stats.getHunger() + 5);
-            gameState.stats.setStamina(gameState.stats.getStamina() - 10);
-            gameState.stats.validateStats();
-            
-            // Trigger node events
-            const Node* newNode = tree.getCurrentNode();
-            if (newNode) {
-                for (int eventId : newNode->getTriggers()) {
-                    if (em.triggerEvent(eventId)) {
-                        Event evt = em.getNextEvent();
-                        gameState.stats.applyEffect(evt.getEffect());
-                        eventLog.push_back(evt);
-                    }
-                }
-            }
-            
-            // Generate random events
-            generateRandomEvent(em, gameState.inventory);
-            
-            // Poll stats for critical events (Algorithm 2, Ch 5.2)
-            em.pollStats(&gameState.stats);
-            
-            std::cout << "DAY " << gameState.day << ": Moved to Node " 
-                      << gameState.currentNodeId << std::endl;
-        }
+        session.choose(selectedChoice);
     }
     
-    // Process high-priority events (Algorithm 2)
-    if (em.hasEvents()) {
-        em.update(&gameState.stats, [&eventLog](const std::string& msg) {
-            Event notification(999, msg, Priority::HIGH, StatEffect());
-            eventLog.push_back(notification);
-            addNotification(msg, ImVec4(1.0f, 0.8f, 0.0f, 1.0f));
-        });
-    }
+    // Real-time timers, then dispatch queued events (Algorithm 2)
+    session.getEvents().advanceRealTime(deltaTime);
+    session.tick();
     
     // Check for ending
-    if (node->isEndingNode() || gameState.stats.isDead()) {
-        std::string endMessage = node->isEndingNode() ? 
-            node->getEndingType() : 
-            "You have perished in the wilderness...";
-        UIManager::displayEndingGUI(endMessage);
+    if (session.isOver()) {
+        UIManager::displayEndingGUI(session.getEndingText());
     }
     
     // Update and render notifications
@@ -257,22 +162,39 @@ int main() {
 
     // Initialize game components
     DecisionTree tree;
-    EventManager em;
-    GameState gameState;  // Centralized state as described in Ch 6.3
-    gameState.inventory = new Inventory();
-    
-    GameStateStack history;
-    ActionQueue actionQueue;  // Now properly integrated with Command pattern
-    std::vector<Event> eventLog;
+
+    // Prefer the compiled story; fall back to the built-in nodes
+    if (!tree.loadFromImage("stories/wolf.wsb")) {
+        tree.loadNodes();
+    }
+
+    // Session owns GameState (Ch 6.3), undo history and the event manager
+    // Event trace for balancing; the game runs without one if it can't be created
+    std::string traceError;
+    if (!EventTrace::open("wolf.trace", traceError)) {
+        std::cerr << "Event trace disabled: " << traceError << std::endl;
+    }
+
+    SessionOptions options;
+    options.eventsPath = "stories/wolf.events";
+    GameSession session(tree, options);
+
+    // Keep event dispatch within a slice of the 16 ms frame
+    DispatchBudget budget;
+    budget.maxMicroseconds = 2000;
+    session.getEvents().setBudget(budget);
+    session.setListener(notifySession);
+
+    // Edits to the story source are patched into the running game
+    StoryWatcher watcher("stories/wolf.story");
+    watcher.start();
+    StoryPatch patch;
 
     bool startGame = false;
     
     // Delta time tracking
     float lastFrameTime = static_cast<float>(glfwGetTime());
 
-    tree.loadNodes();
-    initializeEvents(em);
-
     std::cout << "=== Wolf Pack Survival ===" << std::endl;
     std::cout << "Press U to undo your last choice" << std::endl;
     std::cout << "Press ESC to quit" << std::endl;
@@ -285,6 +207,17 @@ int main() {
         lastFrameTime = currentFrameTime;
         
         glfwPollEvents();
+
+        if (watcher.takePatch(patch)) {
+            if (!patch.error.empty()) {
+                addNotification("Story error: " + patch.error, ImVec4(1.0f, 0.4f, 0.4f, 1.0f));
+            }
+            if (StoryWatcher::apply(tree, patch)) {
+                addNotification("Story reloaded (" + std::to_string(patch.nodes.size()) + " nodes changed)",
+                                ImVec4(0.5f, 0.8f, 1.0f, 1.0f));
+            }
+        }
+
         ImGui_ImplOpenGL3_NewFrame();
         ImGui_ImplGlfw_NewFrame();
         ImGui::NewFrame();
@@ -299,7 +232,7 @@ int main() {
                               ImVec4(0.5f, 1.0f, 0.5f, 1.0f));
             }
         } else {
-            gameLoop(window, tree, em, gameState, history, actionQueue, eventLog, deltaTime);
+            gameLoop(window, session, deltaTime);
         }
 
         ImGui::Render();
@@ -313,18 +246,18 @@ int main() {
     }
 
     std::cout << "\n=== Game Statistics ===" << std::endl;
-    std::cout << "Days Survived: " << gameState.day << std::endl;
-    std::cout << "Final XP: " << gameState.stats.getXP() << std::endl;
-    std::cout << "Undo History Size: " << history.getSize() << std::endl;
+    std::cout << "Days Survived: " << session.getState().day << std::endl;
+    std::cout << "Final XP: " << session.getState().stats.getXP() << std::endl;
+    std::cout << "Undo History Size: " << session.getHistory().getSize() << std::endl;
     std::cout << "Game closed via ESC key." << std::endl;
     std::cout << "=======================" << std::endl;
+    EventTrace::close();
 
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext();
     glfwDestroyWindow(window);
     glfwTerminate();
-    delete gameState.inventory;
 
     return 0;
 }
\ No newline at end of file
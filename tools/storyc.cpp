@@ -0,0 +1,52 @@
+// storyc - compiles a text story into a binary story image
+//
+// Usage: storyc <input.story> <output.wsb>
+//
+// The story graph is validated first; dangling targets, a missing start
+// node or non-ending dead ends are errors, unreachable nodes and cycles
+// are reported as warnings.
+
+#include "../include/DecisionTree.h"
+#include "../include/StoryParser.h"
+
+#include <iostream>
+#include <string>
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::cerr << "Usage: storyc <input.story> <output.wsb>" << std::endl;
+        return 2;
+    }
+
+    DecisionTree tree;
+    std::string error;
+    if (!StoryParser::loadFile(argv[1], tree, error)) {
+        std::cerr << argv[1] << ": " << error << std::endl;
+        return 1;
+    }
+
+    // Errors were already printed by DecisionTree::finalize
+    StoryDiagnostics diagnostics = tree.validate();
+    for (uint32_t n : diagnostics.unreachable) {
+        std::cerr << "Warning: Node " << tree.getNodeAt(n).getId() << " is unreachable" << std::endl;
+    }
+    for (size_t c = 0; c < diagnostics.getCycleCount(); ++c) {
+        std::cerr << "Warning: cycle through nodes";
+        for (uint32_t i = diagnostics.cycleStarts[c]; i < diagnostics.cycleStarts[c + 1]; ++i) {
+            std::cerr << " " << tree.getNodeAt(diagnostics.cycleNodes[i]).getId();
+        }
+        std::cerr << std::endl;
+    }
+    if (diagnostics.hasErrors()) {
+        std::cerr << argv[1] << ": story has errors, not compiled" << std::endl;
+        return 1;
+    }
+
+    if (!tree.compileImage(argv[2])) {
+        std::cerr << "Error: could not write " << argv[2] << std::endl;
+        return 1;
+    }
+
+    std::cout << "Compiled " << argv[1] << " -> " << argv[2] << std::endl;
+    return 0;
+}
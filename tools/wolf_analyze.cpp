@@ -0,0 +1,114 @@
+// wolf_analyze - Monte Carlo ending distribution over many playthroughs
+//
+// Usage: wolf_analyze [--runs N] [--threads T] [--seed S] [--story file]
+//                     [--policy random|first|script] [--script 0,1,0,...]
+//                     [--max-steps N] [--trace file]
+//   --threads  0 (default) uses every hardware thread
+//   --script   choice indices followed before falling back to random
+//   --trace    record every event of every playthrough (see wolf_trace)
+
+#include "../include/DecisionTree.h"
+#include "../include/EventTrace.h"
+#include "../include/PlaythroughAnalyzer.h"
+#include "../include/StoryParser.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+static void usage() {
+    std::cerr << "Usage: wolf_analyze [--runs N] [--threads T] [--seed S] [--story file]\n"
+                 "                    [--policy random|first|script] [--script 0,1,...] [--max-steps N]\n"
+                 "                    [--trace file]"
+              << std::endl;
+}
+
+static double percent(uint64_t count, uint64_t total) {
+    return total ? 100.0 * static_cast<double>(count) / static_cast<double>(total) : 0.0;
+}
+
+int main(int argc, char** argv) {
+    AnalyzerConfig config;
+    std::string storyPath;
+    std::string tracePath;
+
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--runs") && i + 1 < argc) config.playthroughs = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(argv[i], "--threads") && i + 1 < argc) config.threads = static_cast<unsigned int>(std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--seed") && i + 1 < argc) config.seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(argv[i], "--story") && i + 1 < argc) storyPath = argv[++i];
+        else if (!std::strcmp(argv[i], "--max-steps") && i + 1 < argc) config.maxSteps = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--trace") && i + 1 < argc) tracePath = argv[++i];
+        else if (!std::strcmp(argv[i], "--policy") && i + 1 < argc) {
+            std::string policy = argv[++i];
+            if (policy == "random") config.policy = PlayPolicy::Random;
+            else if (policy == "first") config.policy = PlayPolicy::FirstChoice;
+            else if (policy == "script") config.policy = PlayPolicy::Scripted;
+            else { usage(); return 2; }
+        }
+        else if (!std::strcmp(argv[i], "--script") && i + 1 < argc) {
+            std::stringstream in(argv[++i]);
+            std::string item;
+            while (std::getline(in, item, ',')) config.script.push_back(std::atoi(item.c_str()));
+            config.policy = PlayPolicy::Scripted;
+        }
+        else {
+            usage();
+            return 2;
+        }
+    }
+
+    DecisionTree tree;
+    std::string error;
+    if (!StoryParser::loadStory(storyPath, tree, error)) {
+        std::cerr << storyPath << ": " << error << std::endl;
+        return 1;
+    }
+
+    if (!tracePath.empty() && !EventTrace::open(tracePath, error)) {
+        std::cerr << tracePath << ": " << error << std::endl;
+        return 1;
+    }
+
+    // Worker threads flush their trace buffers as they exit
+    AnalyzerReport report = PlaythroughAnalyzer::run(tree, config);
+    EventTrace::close();
+    const uint64_t total = report.playthroughs;
+
+    std::printf("Playthroughs: %llu  Threads: %u  Time: %.3f s  (%.0f playthroughs/s)\n\n",
+                static_cast<unsigned long long>(total), report.threads, report.seconds,
+                report.seconds > 0 ? total / report.seconds : 0.0);
+
+    std::printf("%-50s %12s %8s\n", "Ending", "Count", "Share");
+    for (uint32_t n = 0; n < report.endingCounts.size(); ++n) {
+        Node node = tree.getNodeAt(n);
+        if (!node.isValid() || !node.isEndingNode()) continue;
+        std::string_view type = node.getEndingType();
+        std::printf("%-50.*s %12llu %7.2f%%\n", static_cast<int>(type.size()), type.data(),
+                    static_cast<unsigned long long>(report.endingCounts[n]),
+                    percent(report.endingCounts[n], total));
+    }
+    std::printf("%-50s %12llu %7.2f%%\n", "Died (Stats::isDead)",
+                static_cast<unsigned long long>(report.deaths), percent(report.deaths, total));
+    std::printf("%-50s %12llu %7.2f%%\n\n", "Stalled (no choices or step limit)",
+                static_cast<unsigned long long>(report.stalled), percent(report.stalled, total));
+
+    std::printf("Days survived: avg %.2f  max %d\n\n",
+                total ? static_cast<double>(report.totalDays) / total : 0.0, report.maxDays);
+
+    static const char* statNames[AnalyzerReport::STAT_COUNT] = {
+        "Health", "Hunger", "Stamina", "Pack Status", "Morale", "Strength", "XP"
+    };
+    std::printf("%-12s %8s %6s %6s %6s %6s %6s\n", "Final stat", "mean", "min", "p10", "p50", "p90", "max");
+    for (int s = 0; s < AnalyzerReport::STAT_COUNT; ++s) {
+        const StatHistogram& h = report.stats[s];
+        std::printf("%-12s %8.2f %6lld %6d %6d %6d %6lld\n", statNames[s], h.mean(total),
+                    static_cast<long long>(total ? h.minValue : 0), h.percentile(0.10),
+                    h.percentile(0.50), h.percentile(0.90),
+                    static_cast<long long>(total ? h.maxValue : 0));
+    }
+    return 0;
+}
@@ -0,0 +1,502 @@
+// wolf_bench - DecisionTree scaling benchmark on generated stories
+//
+// Usage: wolf_bench [--sizes 1000,10000,...] [--branching B] [--endings R]
+//                   [--cycles R] [--effects N] [--steps N] [--seed S]
+//                   [--events N] [--wolves N] [--modifiers N]
+//                   [--out results.json] [--emit story.story]
+//   Results are written as JSON (stdout unless --out is given).
+//   --events sets how many events the event queue benchmark pushes (0 skips it).
+//   --wolves sizes the StatsBlock benchmark (0 skips it).
+//   --modifiers sets how many timed modifiers run on a 4096-wolf pack (0 skips it).
+//   --emit writes the story for the first size as text source and exits.
+
+#include "../include/DecisionTree.h"
+#include "../include/EventManager.h"
+#include "../include/EventTrace.h"
+#include "../include/ModifierPool.h"
+#include "../include/StatsBlock.h"
+#include "../include/StoryGenerator.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Allocation-counting hook: every global operator new in this program
+// goes through here, so a timed section can assert it allocated nothing
+namespace {
+std::atomic<uint64_t> allocationCount(0);
+}
+
+void* operator new(size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+// Out of line so GCC does not pair the inlined free() with a builtin new
+[[gnu::noinline]] void operator delete(void* p) noexcept { std::free(p); }
+[[gnu::noinline]] void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+struct Result {
+    uint32_t nodes = 0;
+    uint32_t choices = 0;
+    double generateSeconds = 0;    // producing node definitions only
+    double loadSeconds = 0;        // createNode/addChoice/addTrigger
+    double finalizeSeconds = 0;    // packing, target resolution and validation
+    double makeChoiceNs = 0;
+    double getCurrentNodeNs = 0;
+    double dotSeconds = 0;
+    double bytesPerNode = 0;
+    uint64_t checksum = 0;         // keeps the timed loops from being optimized away
+};
+
+Result runSize(const GeneratorConfig& config, uint64_t steps, const std::string& dotPath) {
+    Result r;
+
+    auto start = Clock::now();
+    uint64_t generated = 0;
+    StoryGenerator::generateNodes(config, [&generated](const StoryNodeDef& node) { generated += node.choices.size(); });
+    r.generateSeconds = secondsSince(start);
+
+    DecisionTree tree;
+    start = Clock::now();
+    StoryGenerator::generateNodes(config, [&tree](const StoryNodeDef& node) { StoryParser::addNode(tree, node); });
+    r.loadSeconds = secondsSince(start) - r.generateSeconds;
+    if (r.loadSeconds < 0) r.loadSeconds = 0;
+
+    start = Clock::now();
+    tree.finalize();
+    r.finalizeSeconds = secondsSince(start);
+
+    r.nodes = tree.getNodeCount();
+    r.choices = tree.getStore().getChoiceCount();
+    r.bytesPerNode = r.nodes ? static_cast<double>(tree.getStore().getMemoryUsage()) / r.nodes : 0.0;
+
+    // Random walk, restarting at endings
+    std::mt19937_64 rng(config.seed);
+    tree.reset();
+    start = Clock::now();
+    for (uint64_t i = 0; i < steps; ++i) {
+        Node node = tree.getCurrentNode();
+        size_t count = node.getChoicesWithEffects().size();
+        if (count == 0) {
+            tree.reset();
+            continue;
+        }
+        tree.makeChoice(static_cast<int>(rng() % count));
+        r.checksum += static_cast<uint64_t>(tree.getCurrentNodeId());
+    }
+    r.makeChoiceNs = steps ? secondsSince(start) * 1e9 / static_cast<double>(steps) : 0.0;
+
+    start = Clock::now();
+    for (uint64_t i = 0; i < steps; ++i) {
+        r.checksum += tree.getCurrentNode().getText().size();
+    }
+    r.getCurrentNodeNs = steps ? secondsSince(start) * 1e9 / static_cast<double>(steps) : 0.0;
+
+    start = Clock::now();
+    tree.generateDotFile(dotPath);
+    r.dotSeconds = secondsSince(start);
+    std::remove(dotPath.c_str());
+
+    return r;
+}
+
+struct EventResult {
+    uint64_t events = 0;
+    double queueMillionsPerSecond = 0;     // EventQueue push + pop of plain IDs
+    double managerMillionsPerSecond = 0;   // EventManager::triggerEvent + popEvent
+    double registerSeconds = 0;            // 50K registrations plus freeze()
+    double ruleMillionsPerSecond = 0;      // rule x entity evaluations
+    double dispatchMillionsPerSecond = 0;  // pushEvent/triggerEvent + update()
+    uint64_t dispatchAllocations = 0;      // heap allocations in the dispatch loop (expected 0)
+    uint64_t dispatchCoalesced = 0;        // submissions merged into a pending duplicate
+    int producers = 0;                     // threads posting through the ingestion queue
+    double ingressMillionsPerSecond = 0;   // postEvent attempts across all producers
+    uint64_t ingressDropped = 0;           // rejected by a full ingestion queue
+    double traceNsPerRecord = 0;           // EventTrace::record, including file writes
+    uint64_t checksum = 0;
+};
+
+EventResult runEvents(uint64_t events) {
+    const int BATCH = 64;
+    const int REGISTRY_SIZE = 50000;
+    const Priority LEVELS[] = { Priority::LOW, Priority::MEDIUM, Priority::HIGH, Priority::CRITICAL };
+    EventResult r;
+    r.events = events;
+
+    EventQueue<int> queue;
+    auto start = Clock::now();
+    for (uint64_t done = 0; done < events; done += BATCH) {
+        for (int i = 0; i < BATCH; ++i) queue.push(LEVELS[(done + i) & 3], i);
+        while (!queue.empty()) r.checksum += static_cast<uint64_t>(queue.pop());
+    }
+    r.queueMillionsPerSecond = static_cast<double>(events) / secondsSince(start) / 1e6;
+
+    EventManager manager;
+    start = Clock::now();
+    manager.reserve(REGISTRY_SIZE, REGISTRY_SIZE);
+    for (int id = 1; id <= REGISTRY_SIZE; ++id) {
+        manager.registerEvent(id, "Benchmark event " + std::to_string(id), LEVELS[id & 3], StatEffect(0, 1));
+    }
+    manager.freeze();
+    r.registerSeconds = secondsSince(start);
+
+    // Scattered IDs across the whole registry
+    std::mt19937 rng(1);
+    std::vector<int> ids(4096);
+    for (int& id : ids) id = static_cast<int>(rng() % REGISTRY_SIZE) + 1;
+    start = Clock::now();
+    for (uint64_t done = 0; done < events; done += BATCH) {
+        for (int i = 0; i < BATCH; ++i) manager.triggerEvent(ids[(done + i) & 4095]);
+        while (manager.hasEvents()) {
+            EventHandle handle = manager.popEvent();
+            r.checksum += static_cast<uint64_t>(manager.resolve(handle).getId());
+            manager.release(handle);
+        }
+    }
+    r.managerMillionsPerSecond = static_cast<double>(events) / secondsSince(start) / 1e6;
+
+    // Rule evaluation: RULES rules over ENTITIES stat rows per tick
+    const size_t RULES = 4096;
+    const size_t ENTITIES = 64;
+    StatRuleSet rules;
+    for (size_t i = 0; i < RULES; ++i) {
+        rules.add({ static_cast<StatId>(i % STAT_COUNT), i & 1 ? Comparator::Above : Comparator::Below,
+                    static_cast<int>(rng() % 100), static_cast<int>(rng() % 10), static_cast<int>(i) });
+    }
+    rules.compile();
+    std::vector<int> values(STAT_COUNT * ENTITIES);
+    StatColumns columns;
+    for (int c = 0; c < STAT_COUNT; ++c) columns.values[c] = &values[c * ENTITIES];
+    columns.count = ENTITIES;
+    std::vector<uint8_t> armed(RULES * ENTITIES, 1), fired(RULES * ENTITIES);
+    const uint64_t ticks = events / (RULES * ENTITIES) + 1;
+    start = Clock::now();
+    for (uint64_t t = 0; t < ticks; ++t) {
+        for (int& v : values) v = static_cast<int>(rng() % 101);
+        r.checksum += rules.evaluate(columns, armed.data(), fired.data());
+    }
+    r.ruleMillionsPerSecond = static_cast<double>(ticks * RULES * ENTITIES) / secondsSince(start) / 1e6;
+
+    // Full dispatch path: dynamic events with actions plus registered
+    // events, drained by update(). One warm-up round sizes every buffer.
+    Stats stats;
+    uint64_t actions = 0;
+    auto notify = [&actions](std::string_view text) { actions += text.size(); };
+    auto dispatchRound = [&](uint64_t round) {
+        for (int i = 0; i < BATCH / 2; ++i) {
+            manager.pushEvent(LEVELS[i & 3], "A dynamic event with a long enough description", [&actions, i]() { actions += i; });
+            manager.triggerEvent(ids[(round + i) & 4095]);
+        }
+        r.dispatchCoalesced += manager.update(&stats, notify).coalesced;
+        stats.reset();
+    };
+    dispatchRound(0);
+    r.dispatchCoalesced = 0;
+    const uint64_t allocationsBefore = allocationCount.load();
+    start = Clock::now();
+    for (uint64_t done = 0; done < events; done += BATCH) dispatchRound(done);
+    r.dispatchMillionsPerSecond = static_cast<double>(events) / secondsSince(start) / 1e6;
+    r.dispatchAllocations = allocationCount.load() - allocationsBefore;
+    r.checksum += actions;
+
+    // Background producers posting while the frame thread keeps updating
+    EventManager shared;
+    for (int id = 1; id <= 4; ++id) shared.registerEvent(id, "Posted event", LEVELS[id - 1], StatEffect(0, 1));
+    shared.freeze();
+    r.producers = std::thread::hardware_concurrency() > 2 ? 3 : 1;
+    const uint64_t perProducer = events / static_cast<uint64_t>(r.producers);
+    std::atomic<int> running(r.producers);
+    std::vector<std::thread> threads;
+    start = Clock::now();
+    for (int t = 0; t < r.producers; ++t) {
+        threads.emplace_back([&shared, &running, perProducer, t]() {
+            for (uint64_t i = 0; i < perProducer; ++i) shared.postEvent(static_cast<int>((i + t) & 3) + 1);
+            running.fetch_sub(1);
+        });
+    }
+    Stats sharedStats;
+    while (running.load() > 0) {
+        shared.update(&sharedStats, nullptr);
+        sharedStats.reset();
+    }
+    shared.update(&sharedStats, nullptr);
+    for (std::thread& thread : threads) thread.join();
+    r.ingressMillionsPerSecond = static_cast<double>(perProducer * r.producers) / secondsSince(start) / 1e6;
+    IngressStats ingress = shared.getIngressStats();
+    r.ingressDropped = ingress.dropped;
+    r.checksum += ingress.drained;
+
+    // Trace recording into a scratch file
+    const char* tracePath = "wolf_bench.wtr";
+    std::string error;
+    if (EventTrace::open(tracePath, error)) {
+        const StatEffect effect(-5, 10, -15, 0, 2);
+        start = Clock::now();
+        for (uint64_t i = 0; i < events; ++i) {
+            EventTrace::record(EventTrace::RecordKind::Dispatched, static_cast<int>(i & 4095), LEVELS[i & 3], 1, effect);
+        }
+        r.traceNsPerRecord = secondsSince(start) * 1e9 / static_cast<double>(events);
+        EventTrace::close();
+        std::remove(tracePath);
+    }
+    return r;
+}
+
+// One StatsBlock kernel: a whole-pack effect and per-wolf deltas
+struct PackResult {
+    const char* kernel = "";
+    double effectMs = 0;       // applyEffect touching every stat
+    double deltasMs = 0;       // applyDeltas on one stat
+    uint64_t checksum = 0;
+};
+
+std::vector<PackResult> runPack(size_t wolves) {
+    const int ROUNDS = 50;
+    std::vector<PackResult> results;
+    const SimdLevel best = StatsBlock::getSimdLevel();
+    std::mt19937 rng(7);
+    std::vector<int8_t> deltas(wolves);
+    for (int8_t& d : deltas) d = static_cast<int8_t>(static_cast<int>(rng() % 41) - 20);
+
+    for (SimdLevel level : { SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2 }) {
+        if (!StatsBlock::setSimdLevel(level)) continue;
+        PackResult r;
+        r.kernel = StatsBlock::getSimdName(level);
+        StatsBlock pack(wolves);
+        const StatEffect effect(-5, 10, -15, 3, -2, 1, 4);
+
+        Clock::time_point start = Clock::now();
+        for (int i = 0; i < ROUNDS; ++i) pack.applyEffect(i & 1 ? effect.reverse() : effect);
+        r.effectMs = secondsSince(start) * 1e3 / ROUNDS;
+
+        start = Clock::now();
+        for (int i = 0; i < ROUNDS; ++i) pack.applyDeltas(StatId::Health, deltas.data());
+        r.deltasMs = secondsSince(start) * 1e3 / ROUNDS;
+
+        for (size_t i = 0; i < wolves; i += 4096) r.checksum += static_cast<uint64_t>(pack.getStat(i, StatId::Health));
+        results.push_back(r);
+    }
+    StatsBlock::setSimdLevel(best);
+    return results;
+}
+
+// Timed modifiers spread over a pack, kept at a steady count by
+// re-applying as many as expire each day
+struct ModifierResult {
+    size_t modifiers = 0;
+    uint32_t wolves = 4096;
+    double addNs = 0;
+    double stepUs = 0;          // one day: sort, sum, apply and expire
+    uint64_t stepAllocations = 0;
+    uint64_t checksum = 0;
+};
+
+ModifierResult runModifiers(size_t count) {
+    const int DAYS = 200;
+    ModifierResult r;
+    r.modifiers = count;
+
+    ModifierPool pool;
+    const int kinds[] = {
+        pool.defineType({ StatEffect(-4, 0, -2), 3, 1, Stacking::Independent, Decay::None }),      // wound
+        pool.defineType({ StatEffect(2, -3, 0, 0, 1), 5, 1, Stacking::Refresh, Decay::Linear }),   // well fed
+        pool.defineType({ StatEffect(0, 0, -8, 0, -2), 4, 3, Stacking::Stack, Decay::Halving }),   // exhausted
+        pool.defineType({ StatEffect(0, 0, 0, 0, 0, 1, 2), 8, 1, Stacking::Independent, Decay::None }),
+    };
+    pool.reserve(count);
+    StatsBlock pack(r.wolves);
+    std::mt19937 rng(11);
+
+    Clock::time_point start = Clock::now();
+    for (size_t i = 0; i < count; ++i) pool.add(rng() % r.wolves, kinds[rng() % 4]);
+    r.addNs = count ? secondsSince(start) * 1e9 / static_cast<double>(count) : 0.0;
+
+    double stepSeconds = 0;
+    for (int day = 0; day < DAYS; ++day) {
+        const uint64_t allocations = allocationCount.load(std::memory_order_relaxed);
+        start = Clock::now();
+        pool.step(pack);
+        stepSeconds += secondsSince(start);
+        if (day > 0) r.stepAllocations += allocationCount.load(std::memory_order_relaxed) - allocations;
+        while (pool.size() < count) pool.add(rng() % r.wolves, kinds[rng() % 4]);
+    }
+    r.stepUs = stepSeconds * 1e6 / DAYS;
+    for (uint32_t i = 0; i < r.wolves; ++i) r.checksum += static_cast<uint64_t>(pack.getStat(i, StatId::Health));
+    return r;
+}
+
+void writeJson(std::ostream& out, const GeneratorConfig& config, uint64_t steps,
+               const std::vector<Result>& results, const EventResult* eventResult,
+               size_t wolves, const std::vector<PackResult>& pack, const ModifierResult* modifiers) {
+    out << "{\n  \"benchmark\": \"wolf_bench\",\n"
+        << "  \"config\": {\"branching\": " << config.branching
+        << ", \"endingRatio\": " << config.endingRatio
+        << ", \"cycleDensity\": " << config.cycleDensity
+        << ", \"effectsPerChoice\": " << config.effectsPerChoice
+        << ", \"steps\": " << steps
+        << ", \"seed\": " << config.seed << "},\n"
+        << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        out << "    {\"nodes\": " << r.nodes
+            << ", \"choices\": " << r.choices
+            << ", \"generateSeconds\": " << r.generateSeconds
+            << ", \"loadSeconds\": " << r.loadSeconds
+            << ", \"finalizeSeconds\": " << r.finalizeSeconds
+            << ", \"makeChoiceNs\": " << r.makeChoiceNs
+            << ", \"getCurrentNodeNs\": " << r.getCurrentNodeNs
+            << ", \"dotSeconds\": " << r.dotSeconds
+            << ", \"bytesPerNode\": " << r.bytesPerNode
+            << ", \"checksum\": " << r.checksum << "}"
+            << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "  ]";
+    if (eventResult) {
+        out << ",\n  \"events\": {\"count\": " << eventResult->events
+            << ", \"queueMillionsPerSecond\": " << eventResult->queueMillionsPerSecond
+            << ", \"managerMillionsPerSecond\": " << eventResult->managerMillionsPerSecond
+            << ", \"registerSeconds\": " << eventResult->registerSeconds
+            << ", \"ruleMillionsPerSecond\": " << eventResult->ruleMillionsPerSecond
+            << ", \"dispatchMillionsPerSecond\": " << eventResult->dispatchMillionsPerSecond
+            << ", \"dispatchAllocations\": " << eventResult->dispatchAllocations
+            << ", \"dispatchCoalesced\": " << eventResult->dispatchCoalesced
+            << ", \"producers\": " << eventResult->producers
+            << ", \"ingressMillionsPerSecond\": " << eventResult->ingressMillionsPerSecond
+            << ", \"ingressDropped\": " << eventResult->ingressDropped
+            << ", \"traceNsPerRecord\": " << eventResult->traceNsPerRecord
+            << ", \"checksum\": " << eventResult->checksum << "}";
+    }
+    if (!pack.empty()) {
+        out << ",\n  \"pack\": {\"wolves\": " << wolves << ", \"kernels\": [\n";
+        for (size_t i = 0; i < pack.size(); ++i) {
+            out << "    {\"kernel\": \"" << pack[i].kernel << "\""
+                << ", \"effectMs\": " << pack[i].effectMs
+                << ", \"deltasMs\": " << pack[i].deltasMs
+                << ", \"checksum\": " << pack[i].checksum << "}"
+                << (i + 1 < pack.size() ? ",\n" : "\n");
+        }
+        out << "  ]}";
+    }
+    if (modifiers) {
+        out << ",\n  \"modifiers\": {\"count\": " << modifiers->modifiers
+            << ", \"wolves\": " << modifiers->wolves
+            << ", \"addNs\": " << modifiers->addNs
+            << ", \"stepUs\": " << modifiers->stepUs
+            << ", \"stepAllocations\": " << modifiers->stepAllocations
+            << ", \"checksum\": " << modifiers->checksum << "}";
+    }
+    out << "\n}\n";
+}
+
+}
+
+int main(int argc, char** argv) {
+    GeneratorConfig config;
+    std::vector<uint32_t> sizes = {1000, 10000, 100000, 1000000};
+    uint64_t steps = 10000000;
+    uint64_t eventCount = 10000000;
+    size_t wolves = 1000000;
+    size_t modifierCount = 32768;
+    std::string outPath;
+    std::string emitPath;
+
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--sizes") && i + 1 < argc) {
+            sizes.clear();
+            std::stringstream in(argv[++i]);
+            std::string item;
+            while (std::getline(in, item, ',')) sizes.push_back(static_cast<uint32_t>(std::strtoul(item.c_str(), nullptr, 10)));
+        }
+        else if (!std::strcmp(argv[i], "--branching") && i + 1 < argc) config.branching = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--endings") && i + 1 < argc) config.endingRatio = std::atof(argv[++i]);
+        else if (!std::strcmp(argv[i], "--cycles") && i + 1 < argc) config.cycleDensity = std::atof(argv[++i]);
+        else if (!std::strcmp(argv[i], "--effects") && i + 1 < argc) config.effectsPerChoice = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--steps") && i + 1 < argc) steps = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(argv[i], "--events") && i + 1 < argc) eventCount = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(argv[i], "--wolves") && i + 1 < argc) wolves = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(argv[i], "--modifiers") && i + 1 < argc) modifierCount = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(argv[i], "--seed") && i + 1 < argc) config.seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(argv[i], "--out") && i + 1 < argc) outPath = argv[++i];
+        else if (!std::strcmp(argv[i], "--emit") && i + 1 < argc) emitPath = argv[++i];
+        else {
+            std::cerr << "Usage: wolf_bench [--sizes N,...] [--branching B] [--endings R] [--cycles R]\n"
+                         "                  [--effects N] [--steps N] [--seed S] [--events N] [--wolves N]\n"
+                         "                  [--modifiers N] [--out file] [--emit file]"
+                      << std::endl;
+            return 2;
+        }
+    }
+    if (sizes.empty()) return 2;
+
+    if (!emitPath.empty()) {
+        config.nodeCount = sizes.front();
+        if (!StoryGenerator::writeSource(emitPath, config)) {
+            std::cerr << "Error: could not write " << emitPath << std::endl;
+            return 1;
+        }
+        std::cout << "Wrote " << config.nodeCount << " nodes -> " << emitPath << std::endl;
+        return 0;
+    }
+
+    std::vector<Result> results;
+    for (uint32_t size : sizes) {
+        config.nodeCount = size;
+        std::cerr << "Benchmarking " << size << " nodes..." << std::endl;
+        results.push_back(runSize(config, steps, "wolf_bench.dot"));
+    }
+
+    EventResult eventResult;
+    if (eventCount > 0) {
+        std::cerr << "Benchmarking " << eventCount << " events..." << std::endl;
+        eventResult = runEvents(eventCount);
+    }
+    const EventResult* events = eventCount > 0 ? &eventResult : nullptr;
+
+    std::vector<PackResult> pack;
+    if (wolves > 0) {
+        std::cerr << "Benchmarking " << wolves << " wolves..." << std::endl;
+        pack = runPack(wolves);
+    }
+
+    ModifierResult modifierResult;
+    if (modifierCount > 0) {
+        std::cerr << "Benchmarking " << modifierCount << " modifiers..." << std::endl;
+        modifierResult = runModifiers(modifierCount);
+    }
+    const ModifierResult* modifiers = modifierCount > 0 ? &modifierResult : nullptr;
+
+    if (outPath.empty()) {
+        writeJson(std::cout, config, steps, results, events, wolves, pack, modifiers);
+        return 0;
+    }
+
+    std::ostringstream json;
+    writeJson(json, config, steps, results, events, wolves, pack, modifiers);
+    std::FILE* file = std::fopen(outPath.c_str(), "w");
+    if (!file) {
+        std::cerr << "Error: could not write " << outPath << std::endl;
+        return 1;
+    }
+    std::fputs(json.str().c_str(), file);
+    std::fclose(file);
+    return 0;
+}
@@ -0,0 +1,397 @@
+// wolf_check - randomized consistency checks for the headless engine
+//
+// Usage: wolf_check [--seed S] [--rounds N]
+//   timers   TimerWheel against a brute-force list of due times, with
+//            cancels, long jumps, overflow delays and save/restore
+//   undo     GameStateStack: every undo returns exactly the state that
+//            was pushed, day schedule included, across dropOldest()
+//   session  GameSession undo against a fresh replay of the choices that
+//            were kept: stats, day, pending day timers and rule flags
+//   --rounds scales the work of every check (default 1).
+//   Prints one line per check and exits non-zero on the first mismatch.
+
+#include "../include/DecisionTree.h"
+#include "../include/GameSession.h"
+#include "../include/GameState.h"
+#include "../include/TimerWheel.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using Rng = std::mt19937_64;
+
+static uint64_t below(Rng& rng, uint64_t n) {
+    return rng() % n;
+}
+
+// ---------------- TimerWheel ----------------
+
+struct ModelTimer {
+    uint64_t expires;
+    uint64_t period;
+    int eventId;         // unique per timer
+    TimerId id;
+    bool alive;
+};
+
+// Delays from one tick to past the top level, weighted towards short ones
+static uint64_t randomDelay(Rng& rng) {
+    switch (below(rng, 8)) {
+        case 0: return 0;
+        case 1: case 2: case 3: return 1 + below(rng, 64);
+        case 4: case 5: return 1 + below(rng, 4096);
+        case 6: return 1 + below(rng, 1u << 18);
+        default: return 1 + below(rng, 1ull << 26);
+    }
+}
+
+static bool checkTimers(uint64_t seed, int rounds, std::string& failure) {
+    Rng rng(seed);
+    TimerWheel wheel;
+    std::vector<ModelTimer> model;
+    std::vector<int> expired;
+    std::vector<std::pair<int, uint64_t>> due;      // (event, time) expected from an advance
+    std::unordered_map<int, size_t> cursor;         // firings of each event checked so far
+    std::vector<TimerWheel::Pending> pending;
+    int nextEvent = 0;
+    size_t alive = 0;
+    const int ops = 100000 * rounds;
+
+    for (int op = 0; op < ops; ++op) {
+        const uint64_t now = wheel.getTime();
+        // Favour cancels once many timers are waiting
+        const uint64_t kind = alive > 2000 ? 45 + below(rng, 55) : below(rng, 100);
+
+        if (kind < 45) {
+            const uint64_t delay = randomDelay(rng);
+            const uint64_t period = below(rng, 4) == 0 ? 1 + below(rng, 200) : 0;
+            ModelTimer timer;
+            timer.expires = now + (delay == 0 ? 1 : delay);
+            timer.period = period;
+            timer.eventId = nextEvent++;
+            timer.id = wheel.schedule(delay, period, timer.eventId);
+            timer.alive = true;
+            model.push_back(timer);
+            ++alive;
+        } else if (kind < 60 && !model.empty()) {
+            // Cancel a random timer; stale handles must be refused
+            ModelTimer& timer = model[below(rng, model.size())];
+            if (wheel.cancel(timer.id) != timer.alive) {
+                failure = "cancel of event " + std::to_string(timer.eventId) + " disagrees";
+                return false;
+            }
+            if (timer.alive) --alive;
+            timer.alive = false;
+        } else if (kind < 98) {
+            uint64_t step = below(rng, 4) == 0 ? below(rng, 1u << 20) : 1 + below(rng, 100);
+            if (below(rng, 500) == 0) step = 1ull << 24;
+            const uint64_t target = now + step;
+
+            // Long jumps only with one-shot timers, so a short period does
+            // not fire thousands of times in one advance
+            if (step > 4096) {
+                for (ModelTimer& timer : model) {
+                    if (!timer.alive || timer.period == 0) continue;
+                    wheel.cancel(timer.id);
+                    timer.alive = false;
+                    --alive;
+                }
+            }
+
+            // Expected firings up to 'target'
+            due.clear();
+            for (ModelTimer& timer : model) {
+                while (timer.alive && timer.expires <= target) {
+                    due.emplace_back(timer.eventId, timer.expires);
+                    if (timer.period > 0) {
+                        timer.expires += timer.period;
+                    } else {
+                        timer.alive = false;
+                        --alive;
+                    }
+                }
+            }
+            std::sort(due.begin(), due.end());
+
+            expired.clear();
+            wheel.advance(target, expired);
+            if (expired.size() != due.size()) {
+                failure = "advance to " + std::to_string(target) + " fired " + std::to_string(expired.size()) +
+                          " timers, expected " + std::to_string(due.size());
+                return false;
+            }
+
+            // The same firings in non-decreasing time: a repeating timer's
+            // n-th firing in the output is its n-th due time
+            cursor.clear();
+            uint64_t last = 0;
+            for (int eventId : expired) {
+                auto first = std::lower_bound(due.begin(), due.end(), std::make_pair(eventId, uint64_t(0)));
+                const size_t index = static_cast<size_t>(first - due.begin()) + cursor[eventId]++;
+                if (index >= due.size() || due[index].first != eventId) {
+                    failure = "advance to " + std::to_string(target) + " fired event " + std::to_string(eventId) +
+                              " too often";
+                    return false;
+                }
+                if (due[index].second < last) {
+                    failure = "advance to " + std::to_string(target) + " fired out of order";
+                    return false;
+                }
+                last = due[index].second;
+            }
+        } else {
+            // Save and restore, as EventManager::restoreSchedule() does
+            wheel.getPending(pending);
+            wheel.clear(now);
+            std::sort(pending.begin(), pending.end(),
+                      [](const TimerWheel::Pending& a, const TimerWheel::Pending& b) { return a.eventId < b.eventId; });
+            for (ModelTimer& timer : model) {
+                if (!timer.alive) continue;
+                auto it = std::lower_bound(pending.begin(), pending.end(), timer.eventId,
+                                           [](const TimerWheel::Pending& p, int id) { return p.eventId < id; });
+                if (it == pending.end() || it->eventId != timer.eventId || it->expires != timer.expires ||
+                    it->period != timer.period) {
+                    failure = "getPending lost event " + std::to_string(timer.eventId);
+                    return false;
+                }
+                timer.id = wheel.schedule(timer.expires - now, timer.period, timer.eventId);
+            }
+        }
+
+        // Keep the model small: forget timers that are gone
+        if (model.size() > 4096) {
+            model.erase(std::remove_if(model.begin(), model.end(), [](const ModelTimer& t) { return !t.alive; }),
+                        model.end());
+        }
+
+        if (wheel.size() != alive) {
+            failure = "size " + std::to_string(wheel.size()) + ", expected " + std::to_string(alive);
+            return false;
+        }
+    }
+
+    std::cout << "timers: " << ops << " operations, " << nextEvent << " timers, time "
+              << wheel.getTime() << ": ok" << std::endl;
+    return true;
+}
+
+// ---------------- GameStateStack ----------------
+
+struct SavedState {
+    int nodeId;
+    StatEffect stats;
+    int day;
+    int packSize;
+    std::vector<std::pair<std::string, int>> items;
+    DaySchedule schedule;
+
+    bool operator==(const SavedState& other) const {
+        return nodeId == other.nodeId && stats == other.stats && day == other.day &&
+               packSize == other.packSize && items == other.items && schedule == other.schedule;
+    }
+};
+
+static SavedState saved(const GameState& state, const DaySchedule& schedule) {
+    SavedState s{ state.currentNodeId, state.stats.getValues(), state.day, state.packSize, {}, schedule };
+    for (const InventoryNode* item = state.inventory->getHead(); item; item = item->next) {
+        s.items.push_back({ item->name, item->quantity });
+    }
+    return s;
+}
+
+static bool checkUndo(uint64_t seed, int rounds, std::string& failure) {
+    Rng rng(seed);
+    const char* names[] = { "Winter Berries", "Healing Herbs", "Dried Meat", "Bone" };
+    const int pushes = GameStateStack::MAX_SIZE + 20000 * rounds;
+
+    GameStateStack stack;
+    Inventory inventory;
+    GameState state;
+    state.inventory = &inventory;
+    DaySchedule schedule;
+    schedule.ruleArmed.assign(4, 1);
+    std::vector<SavedState> expected;
+
+    for (int i = 0; i < pushes; ++i) {
+        stack.push(state.currentNodeId, state.stats, state.inventory, state.day, state.packSize, &schedule);
+        expected.push_back(saved(state, schedule));
+
+        state.currentNodeId = static_cast<int>(below(rng, 3000));
+        state.day += below(rng, 50) == 0 ? -static_cast<int>(below(rng, 5)) : 1;
+        if (below(rng, 40) == 0) state.packSize += static_cast<int>(below(rng, 5)) - 2;
+        state.stats.applyEffect(StatEffect(static_cast<int>(below(rng, 61)) - 30, static_cast<int>(below(rng, 41)) - 20,
+                                           static_cast<int>(below(rng, 41)) - 20, 0,
+                                           static_cast<int>(below(rng, 11)) - 5, 0, static_cast<int>(below(rng, 3))));
+        if (below(rng, 3) == 0) {
+            int effect;
+            std::string type;
+            const char* name = names[below(rng, 4)];
+            if (below(rng, 2)) inventory.addItem(name, "FOOD", 10, 1 + static_cast<int>(below(rng, 3)));
+            else inventory.useItem(name, effect, type);
+        }
+        if (below(rng, 4) == 0) schedule.ruleArmed[below(rng, 4)] ^= 1;
+        if (below(rng, 5) == 0) {
+            const int delay = 1 + static_cast<int>(below(rng, below(rng, 10) == 0 ? 100000 : 5));
+            schedule.timers.push_back({ static_cast<int>(below(rng, 300)), state.day + delay,
+                                        static_cast<uint32_t>(below(rng, 3) == 0 ? below(rng, 30) : 0) });
+            std::sort(schedule.timers.begin(), schedule.timers.end());
+        }
+        if (below(rng, 6) == 0) {
+            schedule.modifiers.push_back({ static_cast<uint32_t>(below(rng, 3)), static_cast<int>(below(rng, 4)),
+                                           1 + static_cast<int>(below(rng, 3)), state.day,
+                                           state.day + 1 + static_cast<int>(below(rng, 6)) });
+            std::sort(schedule.modifiers.begin(), schedule.modifiers.end());
+        }
+        // Timers that came due and modifiers that ran out are gone by the next push
+        schedule.timers.erase(std::remove_if(schedule.timers.begin(), schedule.timers.end(),
+                                             [&state](const DayTimer& t) { return t.dueDay <= state.day; }),
+                              schedule.timers.end());
+        schedule.modifiers.erase(std::remove_if(schedule.modifiers.begin(), schedule.modifiers.end(),
+                                                [&state](const DayModifier& m) { return m.lastDay <= state.day; }),
+                                 schedule.modifiers.end());
+    }
+
+    const size_t memory = stack.getMemoryUsage();
+    const int kept = stack.getSize();
+    GameState out;
+    Inventory outInventory;
+    out.inventory = &outInventory;
+    DaySchedule outSchedule;
+    size_t next = expected.size();
+    while (stack.undo(out, &outSchedule)) {
+        --next;
+        if (!(saved(out, outSchedule) == expected[next])) {
+            failure = "undo to push " + std::to_string(next) + " is not the state pushed";
+            return false;
+        }
+    }
+    if (expected.size() - next != static_cast<size_t>(kept)) {
+        failure = "undid " + std::to_string(expected.size() - next) + " of " + std::to_string(kept) + " steps";
+        return false;
+    }
+
+    std::cout << "undo: " << pushes << " pushes, " << kept << " kept, "
+              << static_cast<double>(memory) / kept << " bytes per step: ok" << std::endl;
+    return true;
+}
+
+// ---------------- GameSession ----------------
+
+struct Move {
+    int choice;
+    int roll;
+};
+
+static bool checkSession(uint64_t seed, int rounds, std::string& failure) {
+    Rng rng(seed);
+    DecisionTree story;
+    story.loadNodes();
+
+    SessionOptions options;
+    options.verbose = false;
+    options.keepEventLog = false;
+    options.keepStatHistory = false;
+    options.seed = 1;
+    DecisionTree tree;
+    tree.attachStory(story);
+    GameSession live(tree, options);
+
+    SessionOptions replayOptions = options;
+    replayOptions.trackHistory = false;
+    DecisionTree replayTree;
+    replayTree.attachStory(story);
+    GameSession replay(replayTree, replayOptions);
+
+    DaySchedule a, b;
+    std::vector<Move> path;
+    int checks = 0, undos = 0, withTimers = 0, withModifiers = 0, chosen = 0;
+    size_t journalBytes = 0;
+    const int games = 1000 * rounds;
+
+    for (int game = 0; game < games; ++game) {
+        live.restart();
+        path.clear();
+        for (int step = 0; step < 40 && !live.isOver(); ++step) {
+            if (!path.empty() && below(rng, 3) == 0) {
+                live.undo();
+                path.pop_back();
+                ++undos;
+            } else {
+                const int choices = static_cast<int>(tree.getCurrentNode().getChoicesWithEffects().size());
+                if (choices == 0) break;
+                Move move{ static_cast<int>(below(rng, choices)), 1 + static_cast<int>(below(rng, 100)) };
+                path.push_back(move);
+                const size_t before = live.getHistory().getJournalSize();
+                live.resolveChoice(move.choice, move.roll);
+                live.drainEvents();
+                journalBytes += live.getHistory().getJournalSize() - before;
+                ++chosen;
+            }
+
+            replay.restart();
+            for (const Move& move : path) {
+                replay.resolveChoice(move.choice, move.roll);
+                replay.drainEvents();
+            }
+
+            live.getEvents().saveSchedule(a);
+            replay.getEvents().saveSchedule(b);
+            const GameState& x = live.getState();
+            const GameState& y = replay.getState();
+            ++checks;
+            withTimers += !a.timers.empty();
+            withModifiers += !a.modifiers.empty();
+            if (!(a == b) || x.day != y.day || x.currentNodeId != y.currentNodeId ||
+                !(x.stats.getValues() == y.stats.getValues())) {
+                failure = "game " + std::to_string(game) + ", step " + std::to_string(step) + ": day " +
+                          std::to_string(x.day) + " with " + std::to_string(a.timers.size()) +
+                          " timers and " + std::to_string(a.modifiers.size()) + " modifiers, replay day " +
+                          std::to_string(y.day) + " with " + std::to_string(b.timers.size()) + " and " +
+                          std::to_string(b.modifiers.size());
+                return false;
+            }
+        }
+    }
+
+    std::cout << "session: " << games << " games, " << undos << " undos, " << checks << " checks ("
+              << withTimers << " with timers pending, " << withModifiers << " with modifiers active), "
+              << static_cast<double>(journalBytes) / (chosen > 0 ? chosen : 1) << " journal bytes per choice: ok"
+              << std::endl;
+    return true;
+}
+
+int main(int argc, char** argv) {
+    uint64_t seed = 1;
+    int rounds = 1;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--seed") && i + 1 < argc) seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(argv[i], "--rounds") && i + 1 < argc) rounds = std::atoi(argv[++i]);
+        else {
+            std::cerr << "Usage: wolf_check [--seed S] [--rounds N]" << std::endl;
+            return 2;
+        }
+    }
+    if (rounds < 1) rounds = 1;
+
+    std::string failure;
+    if (!checkTimers(seed, rounds, failure)) {
+        std::cerr << "timers: FAILED: " << failure << std::endl;
+        return 1;
+    }
+    if (!checkUndo(seed, rounds, failure)) {
+        std::cerr << "undo: FAILED: " << failure << std::endl;
+        return 1;
+    }
+    if (!checkSession(seed, rounds, failure)) {
+        std::cerr << "session: FAILED: " << failure << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,86 @@
+// wolf_explore - exhaustive search of every reachable game state
+//
+// Usage: wolf_explore [--story file] [--max-states N] [--no-encounters] [--nodes]
+//   --no-encounters  ignore random encounters (choice effects only)
+//   --nodes          print the stat ranges of every reachable node
+
+#include "../include/DecisionTree.h"
+#include "../include/StateExplorer.h"
+#include "../include/StoryParser.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+static void printEnding(const DecisionTree& tree, uint32_t index, const NodeSummary& summary) {
+    Node node = tree.getNodeAt(index);
+    std::string_view type = node.getEndingType();
+    std::printf("  node %-6d %-46.*s", node.getId(), static_cast<int>(type.size()), type.data());
+    if (summary.minDepth >= 0) {
+        std::printf(" %10llu states, %d+ choices", static_cast<unsigned long long>(summary.states), summary.minDepth);
+    }
+    std::printf("\n");
+}
+
+int main(int argc, char** argv) {
+    ExplorerConfig config;
+    std::string storyPath;
+    bool listNodes = false;
+
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--story") && i + 1 < argc) storyPath = argv[++i];
+        else if (!std::strcmp(argv[i], "--max-states") && i + 1 < argc) config.maxStates = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(argv[i], "--no-encounters")) config.randomEncounters = false;
+        else if (!std::strcmp(argv[i], "--nodes")) listNodes = true;
+        else {
+            std::cerr << "Usage: wolf_explore [--story file] [--max-states N] [--no-encounters] [--nodes]" << std::endl;
+            return 2;
+        }
+    }
+
+    DecisionTree tree;
+    std::string error;
+    if (!StoryParser::loadStory(storyPath, tree, error)) {
+        std::cerr << storyPath << ": " << error << std::endl;
+        return 1;
+    }
+
+    ExplorerReport report = StateExplorer::run(tree, config);
+
+    std::printf("States: %llu  Transitions: %llu  Memory: %.1f MB  Time: %.3f s%s\n",
+                static_cast<unsigned long long>(report.states),
+                static_cast<unsigned long long>(report.transitions),
+                report.memoryBytes / (1024.0 * 1024.0), report.seconds,
+                report.truncated ? "  (TRUNCATED)" : "");
+    std::printf("Death states: %llu  XP saturated: %llu\n\n",
+                static_cast<unsigned long long>(report.deathStates),
+                static_cast<unsigned long long>(report.xpSaturated));
+
+    std::printf("Reachable endings (%zu):\n", report.reachableEndings.size());
+    for (uint32_t n : report.reachableEndings) printEnding(tree, n, report.nodes[n]);
+    std::printf("Unreachable endings (%zu):\n", report.unreachableEndings.size());
+    for (uint32_t n : report.unreachableEndings) printEnding(tree, n, report.nodes[n]);
+
+    size_t unreachable = 0;
+    for (const NodeSummary& summary : report.nodes) {
+        if (summary.minDepth < 0) ++unreachable;
+    }
+    std::printf("\nUnreachable nodes: %zu of %zu\n", unreachable, report.nodes.size());
+
+    if (listNodes) {
+        static const char* names[PackedState::STAT_COUNT] = {"HP", "Hun", "Sta", "Pack", "Mor", "Str", "XP"};
+        std::printf("\n%-8s %10s", "Node", "States");
+        for (const char* name : names) std::printf(" %9s", name);
+        std::printf("\n");
+        for (uint32_t n = 0; n < report.nodes.size(); ++n) {
+            const NodeSummary& summary = report.nodes[n];
+            if (summary.minDepth < 0) continue;
+            std::printf("%-8d %10llu", tree.getNodeAt(n).getId(), static_cast<unsigned long long>(summary.states));
+            for (const StatRange& range : summary.stats) std::printf(" %4d..%-4d", range.minValue, range.maxValue);
+            std::printf("\n");
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,73 @@
+// wolf_export - writes the story graph as DOT, GraphML or binary CSR
+//
+// Usage: wolf_export [--story file] [--format dot|graphml|csr]
+//                    [--around NODE --hops K] <output>
+//   --around  export only the nodes within K choices of NODE
+
+#include "../include/DecisionTree.h"
+#include "../include/StoryParser.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+static void usage() {
+    std::cerr << "Usage: wolf_export [--story file] [--format dot|graphml|csr] [--around NODE --hops K] <output>"
+              << std::endl;
+}
+
+int main(int argc, char** argv) {
+    std::string storyPath;
+    std::string output;
+    GraphFormat format = GraphFormat::Dot;
+    int around = 0;
+    int hops = 2;
+    bool subgraph = false;
+
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--story") && i + 1 < argc) storyPath = argv[++i];
+        else if (!std::strcmp(argv[i], "--around") && i + 1 < argc) { around = std::atoi(argv[++i]); subgraph = true; }
+        else if (!std::strcmp(argv[i], "--hops") && i + 1 < argc) hops = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--format") && i + 1 < argc) {
+            std::string name = argv[++i];
+            if (name == "dot") format = GraphFormat::Dot;
+            else if (name == "graphml") format = GraphFormat::GraphML;
+            else if (name == "csr") format = GraphFormat::BinaryCsr;
+            else { usage(); return 2; }
+        }
+        else if (argv[i][0] != '-' && output.empty()) output = argv[i];
+        else { usage(); return 2; }
+    }
+    if (output.empty()) {
+        usage();
+        return 2;
+    }
+
+    DecisionTree tree;
+    std::string error;
+    if (!StoryParser::loadStory(storyPath, tree, error)) {
+        std::cerr << storyPath << ": " << error << std::endl;
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    bool ok;
+    size_t exported = tree.getNodeCount();
+    if (subgraph) {
+        tree.setCurrentNode(around);
+        ok = tree.exportNeighborhood(output, format, hops, &exported);
+    } else {
+        ok = tree.exportGraph(output, format);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (!ok) {
+        std::cerr << "Error: could not write " << output << std::endl;
+        return 1;
+    }
+    std::cout << "Exported " << exported << " nodes -> " << output
+              << " (" << seconds << " s)" << std::endl;
+    return 0;
+}
@@ -0,0 +1,88 @@
+// wolf_sim - headless playthroughs without GLFW/OpenGL
+//
+// Usage: wolf_sim [--runs N] [--seed S] [--story file] [--history] [--verbose]
+//                 [--trace file]
+//   --story    compiled .wsb image or text .story source (default: built-in nodes)
+//   --history  keep the undo journal, commands and stat history like the game does
+//   --verbose  print every day and the ending of each run
+//   --trace    record every event to a binary trace (see wolf_trace)
+
+#include "../include/DecisionTree.h"
+#include "../include/EventTrace.h"
+#include "../include/GameSession.h"
+#include "../include/StoryParser.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+
+int main(int argc, char** argv) {
+    long runs = 1;
+    unsigned int seed = 1;
+    std::string storyPath;
+    std::string tracePath;
+    SessionOptions options;
+    options.trackHistory = false;
+    options.keepEventLog = false;
+    options.keepStatHistory = false;
+    options.verbose = false;
+
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--runs") && i + 1 < argc) runs = std::atol(argv[++i]);
+        else if (!std::strcmp(argv[i], "--seed") && i + 1 < argc) seed = static_cast<unsigned int>(std::atol(argv[++i]));
+        else if (!std::strcmp(argv[i], "--story") && i + 1 < argc) storyPath = argv[++i];
+        else if (!std::strcmp(argv[i], "--history")) options.trackHistory = options.keepEventLog = options.keepStatHistory = true;
+        else if (!std::strcmp(argv[i], "--verbose")) options.verbose = true;
+        else if (!std::strcmp(argv[i], "--trace") && i + 1 < argc) tracePath = argv[++i];
+        else {
+            std::cerr << "Usage: wolf_sim [--runs N] [--seed S] [--story file] [--history] [--verbose]\n"
+                         "                [--trace file]" << std::endl;
+            return 2;
+        }
+    }
+
+    DecisionTree tree;
+    std::string error;
+    if (!StoryParser::loadStory(storyPath, tree, error)) {
+        std::cerr << storyPath << ": " << error << std::endl;
+        return 1;
+    }
+
+    if (!tracePath.empty() && !EventTrace::open(tracePath, error)) {
+        std::cerr << tracePath << ": " << error << std::endl;
+        return 1;
+    }
+
+    options.seed = seed;
+    GameSession session(tree, options);
+    std::mt19937 policy(seed ^ 0x9E3779B9u);
+
+    long steps = 0;
+    long deaths = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    for (long run = 0; run < runs; ++run) {
+        session.restart();
+        while (!session.isOver()) {
+            size_t choiceCount = tree.getCurrentNode().getChoicesWithEffects().size();
+            if (choiceCount == 0) break;
+            session.step(static_cast<int>(policy() % choiceCount));
+            ++steps;
+        }
+        if (session.getState().stats.isDead()) ++deaths;
+        if (options.verbose) {
+            std::cout << "Run " << run + 1 << ": " << session.getEndingText()
+                      << " (day " << session.getState().day << ")" << std::endl;
+        }
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    EventTrace::close();
+    std::cout << "Runs: " << runs << "  Steps: " << steps << "  Deaths: " << deaths << std::endl;
+    std::cout << "Time: " << seconds << " s  (" << (seconds > 0 ? steps / seconds : 0.0)
+              << " steps/s)" << std::endl;
+    return 0;
+}
@@ -0,0 +1,140 @@
+// wolf_trace - per-event tables from a binary event trace (.wtr)
+//
+// Usage: wolf_trace <trace file>
+//
+// Traces are written by the game (wolf.trace) and by wolf_sim and
+// wolf_analyze with --trace. Prints how often each event was queued,
+// dispatched, merged and dropped, the latency from its first trigger to
+// dispatch, and the stat deltas it applied. Pushed events without a
+// registered ID are reported together as event -1.
+
+#include "../include/EventTrace.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+struct EventTotals {
+    int priority = 0;
+    uint64_t queued = 0;
+    uint64_t dispatched = 0;
+    uint64_t merged = 0;        // triggers folded into another occurrence
+    uint64_t dropped = 0;
+    uint64_t immediate = 0;
+    std::vector<double> latencies;   // seconds, one per dispatch
+    long long delta[7] = {};
+};
+
+static double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    size_t index = static_cast<size_t>(p * static_cast<double>(sorted.size() - 1) + 0.5);
+    return sorted[index];
+}
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        std::cerr << "Usage: wolf_trace <trace file>" << std::endl;
+        return 2;
+    }
+
+    EventTrace::Header header;
+    std::vector<EventTrace::Record> records;
+    std::string error;
+    if (!EventTrace::load(argv[1], header, records, error)) {
+        std::cerr << argv[1] << ": " << error << std::endl;
+        return 1;
+    }
+
+    // Unclosed traces have no tick rate; latencies are then in ticks
+    const bool calibrated = header.ticksPerSecond > 0;
+    const double secondsPerTick = calibrated ? 1.0 / header.ticksPerSecond : 1.0;
+
+    // Pending trigger times per thread, event and priority. A thread's
+    // records are in order, and equal events dispatch first in, first out.
+    std::map<std::tuple<int, int, int>, std::deque<uint64_t>> waiting;
+    std::map<int, EventTotals> events;
+    uint64_t first = records.empty() ? 0 : records[0].timestamp;
+    uint64_t last = first;
+    int threads = 0;
+
+    for (const EventTrace::Record& r : records) {
+        first = std::min(first, r.timestamp);
+        last = std::max(last, r.timestamp);
+        threads = std::max(threads, static_cast<int>(r.thread) + 1);
+
+        EventTotals& totals = events[r.eventId];
+        totals.priority = r.priority;
+        std::deque<uint64_t>& queue = waiting[std::make_tuple(r.thread, r.eventId, r.priority)];
+
+        switch (static_cast<EventTrace::RecordKind>(r.kind)) {
+        case EventTrace::RecordKind::Queued:
+            ++totals.queued;
+            queue.push_back(r.timestamp);
+            break;
+        case EventTrace::RecordKind::Dispatched:
+        case EventTrace::RecordKind::Dropped: {
+            if (r.kind == static_cast<uint8_t>(EventTrace::RecordKind::Dropped)) ++totals.dropped;
+            else ++totals.dispatched;
+            totals.merged += r.repeat > 1 ? r.repeat - 1u : 0u;
+            if (!queue.empty()) {
+                totals.latencies.push_back(static_cast<double>(r.timestamp - queue.front()) * secondsPerTick);
+            }
+            for (int n = 0; n < r.repeat && !queue.empty(); ++n) queue.pop_front();
+            break;
+        }
+        case EventTrace::RecordKind::Immediate:
+            ++totals.immediate;
+            break;
+        }
+        if (r.kind == static_cast<uint8_t>(EventTrace::RecordKind::Dispatched) ||
+            r.kind == static_cast<uint8_t>(EventTrace::RecordKind::Immediate)) {
+            for (int s = 0; s < 7; ++s) totals.delta[s] += r.delta[s];
+        }
+    }
+
+    std::printf("Records: %zu  Threads: %d  Span: %.3f %s\n\n", records.size(), threads,
+                static_cast<double>(last - first) * secondsPerTick, calibrated ? "s" : "ticks (trace not closed)");
+
+    static const char* priorityNames[] = { "?", "LOW", "MEDIUM", "HIGH", "CRITICAL" };
+    std::printf("%-8s %-9s %10s %10s %10s %10s %10s\n",
+                "Event", "Priority", "Queued", "Dispatched", "Merged", "Dropped", "Immediate");
+    for (const auto& entry : events) {
+        const EventTotals& t = entry.second;
+        std::printf("%-8d %-9s %10llu %10llu %10llu %10llu %10llu\n", entry.first,
+                    priorityNames[t.priority <= 4 ? t.priority : 0],
+                    static_cast<unsigned long long>(t.queued), static_cast<unsigned long long>(t.dispatched),
+                    static_cast<unsigned long long>(t.merged), static_cast<unsigned long long>(t.dropped),
+                    static_cast<unsigned long long>(t.immediate));
+    }
+
+    const double unit = calibrated ? 1e6 : 1.0;
+    std::printf("\nLatency, first trigger to dispatch (%s)\n", calibrated ? "us" : "ticks");
+    std::printf("%-8s %10s %12s %12s %12s %12s\n", "Event", "Samples", "mean", "p50", "p99", "max");
+    for (auto& entry : events) {
+        std::vector<double>& l = entry.second.latencies;
+        if (l.empty()) continue;
+        std::sort(l.begin(), l.end());
+        double sum = 0;
+        for (double v : l) sum += v;
+        std::printf("%-8d %10zu %12.2f %12.2f %12.2f %12.2f\n", entry.first, l.size(),
+                    sum / static_cast<double>(l.size()) * unit, percentile(l, 0.50) * unit,
+                    percentile(l, 0.99) * unit, l.back() * unit);
+    }
+
+    std::printf("\nStat impact (sum of applied deltas)\n");
+    std::printf("%-8s %9s %9s %9s %9s %9s %9s %9s\n",
+                "Event", "Health", "Hunger", "Stamina", "Pack", "Morale", "Strength", "XP");
+    for (const auto& entry : events) {
+        const EventTotals& t = entry.second;
+        if (t.dispatched + t.immediate == 0) continue;
+        std::printf("%-8d", entry.first);
+        for (int s = 0; s < 7; ++s) std::printf(" %9lld", t.delta[s]);
+        std::printf("\n");
+    }
+    return 0;
+}